@@ -0,0 +1,640 @@
+#include "bench_common.h"
+#include "game_alloc.h"
+#include "platform.h"
+#include "ecs.h"
+#include "scenes.h"
+#include <string.h>
+
+// Deterministic benchmark of the scene loop, for CI machines without a GPU.
+// Simulates N frames of scripted input and reports ticks/sec, per-scene update cost
+// and heap allocations made by game code.
+//
+// Usage: CeliseBench [ticks] [script]
+//        CeliseBench --ecs [ticks]   entity systems at 10k-100k entities, SoA vs array-of-structs,
+//                                    then the animation kernels at 50k entities
+//        CeliseBench --startup [bundle] [runs]
+//                                    time to first frame from loose files vs the asset bundle
+//        CeliseBench --save [runs]   quicksave and load cost in the castle, with a full inventory
+//        CeliseBench --jobs [ticks]  entity systems at 200k entities on 1 to N threads
+//        CeliseBench --items [queries]
+//                                    inventory queries at 256-4096 slots, indexed vs string slots
+
+// The layout the entity systems replaced, one struct per entity, kept here as the baseline
+typedef struct {
+	EntityId id;
+	Vector2 position;
+	Vector2 prevPosition;
+	Vector2 velocity;
+	float timer;
+	float frameTime;
+	int currentFrame;
+	int frameCount;
+	float direction;
+	EntityState state;
+	Rectangle frame; // Sheet origin and frame size
+	Rectangle sourceRect;
+	const char* name;
+} AosEntity;
+
+static void TickAosEntities(AosEntity* entities, int count, float dt)
+{
+	for (int i = 0; i < count; i++) entities[i].prevPosition = entities[i].position;
+	for (int i = 0; i < count; i++)
+	{
+		entities[i].position.x += entities[i].velocity.x * dt;
+		entities[i].position.y += entities[i].velocity.y * dt;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		AosEntity* e = &entities[i];
+		if (e->state != IDLE)
+		{
+			e->timer += dt;
+			if (e->timer >= e->frameTime)
+			{
+				e->currentFrame = (e->currentFrame + 1) % e->frameCount;
+				e->timer = 0.0f;
+			}
+		}
+		e->sourceRect = (Rectangle) { e->frame.x + (float)e->currentFrame * e->frame.width, e->frame.y,
+			e->frame.width * e->direction, e->frame.height };
+	}
+}
+
+// A mix of idle, walking and running entities with differing frame counts
+static void PopulateWorld(EntityWorld* world, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		EntityId id = SpawnEntity(world, (Vector2) { (float)(i % 1280), (float)(i % 720) }, "bench");
+		int k = GetEntityIndex(world, id);
+		world->velX[k] = (float)(i % 7) * 30.0f - 90.0f;
+		world->velY[k] = (float)(i % 5) * 20.0f - 40.0f;
+		world->state[k] = (unsigned char)(i % 3);
+		world->frameCount[k] = 4 + i % 3;
+		world->frameTime[k] = 0.05f + (float)(i % 4) * 0.025f;
+		world->direction[k] = (i & 1) ? 1.0f : -1.0f;
+		world->sheetX[k] = (float)(i % 8) * 64.0f;
+		world->frameWidth[k] = 180.0f;
+		world->frameHeight[k] = 220.0f;
+	}
+}
+
+// Times AnimateEntities with each kernel on identical worlds and checks they agree
+static int BenchAnimationKernels(int count, int ticks)
+{
+	const float dt = 1.0f / SIM_TICK_RATE;
+	EntityWorld* reference = NULL;
+
+	printf("\n%10s %16s %16s\n", "kernel", "ms/tick @ 50k", "matches scalar");
+	for (int k = ANIMATION_KERNEL_SCALAR; k <= ANIMATION_KERNEL_AVX2; k++)
+	{
+		if (SetAnimationKernel((AnimationKernel)k) != (AnimationKernel)k)
+		{
+			printf("%10s %16s\n", GetAnimationKernelName((AnimationKernel)k), "unsupported");
+			continue;
+		}
+		EntityWorld* world = CreateEntityWorld(count);
+		if (!world) return 1;
+		PopulateWorld(world, count);
+
+		double start = PlatformGetTime();
+		for (int t = 0; t < ticks; t++)
+		{
+			AnimateEntities(world, dt);
+		}
+		double elapsed = PlatformGetTime() - start;
+
+		bool matches = true;
+		if (!reference)
+		{
+			reference = world;
+		}
+		else
+		{
+			matches = memcmp(world->animFrame, reference->animFrame, sizeof(int) * count) == 0 &&
+				memcmp(world->animTimer, reference->animTimer, sizeof(float) * count) == 0 &&
+				memcmp(world->sourceRects, reference->sourceRects, sizeof(Rectangle) * count) == 0;
+			DestroyEntityWorld(world);
+		}
+		printf("%10s %16.4f %16s\n", GetAnimationKernelName((AnimationKernel)k), elapsed * 1e3 / ticks, matches ? "yes" : "NO");
+		if (!matches) return 1;
+	}
+	DestroyEntityWorld(reference);
+	SetAnimationKernel(ANIMATION_KERNEL_AVX2);
+	return 0;
+}
+
+static int BenchEntities(int ticks)
+{
+	static const int counts[] = { 10000, 25000, 50000, 100000 };
+	const float dt = 1.0f / SIM_TICK_RATE;
+
+	printf("\n---------------- Entity system benchmark ----------------\n");
+	printf("%10s %16s %16s %10s\n", "entities", "SoA ns/entity", "AoS ns/entity", "speedup");
+	for (int c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); c++)
+	{
+		int count = counts[c];
+		EntityWorld* world = CreateEntityWorld(count);
+		AosEntity* aos = (AosEntity*)GameAlloc(sizeof(AosEntity) * count);
+		if (!world || !aos) return 1;
+		memset(aos, 0, sizeof(AosEntity) * count);
+
+		// Same population in both layouts
+		PopulateWorld(world, count);
+		for (int k = 0; k < count; k++)
+		{
+			aos[k].id = world->ids[k];
+			aos[k].position = (Vector2) { world->posX[k], world->posY[k] };
+			aos[k].velocity = (Vector2) { world->velX[k], world->velY[k] };
+			aos[k].frameTime = world->frameTime[k];
+			aos[k].frameCount = world->frameCount[k];
+			aos[k].direction = world->direction[k];
+			aos[k].state = (EntityState)world->state[k];
+			aos[k].frame = (Rectangle) { world->sheetX[k], world->sheetY[k], world->frameWidth[k], world->frameHeight[k] };
+			aos[k].name = world->names[k];
+		}
+
+		double start = PlatformGetTime();
+		for (int t = 0; t < ticks; t++)
+		{
+			SaveEntityPositions(world);
+			MoveEntities(world, dt);
+			AnimateEntities(world, dt);
+		}
+		double soa = PlatformGetTime() - start;
+
+		start = PlatformGetTime();
+		for (int t = 0; t < ticks; t++)
+		{
+			TickAosEntities(aos, count, dt);
+		}
+		double aosTime = PlatformGetTime() - start;
+
+		// Keep both results observable so neither loop is optimized away
+		volatile float sink = world->posX[count - 1] + aos[count - 1].position.x;
+		(void)sink;
+
+		printf("%10d %16.3f %16.3f %9.2fx\n", count, soa * 1e9 / ((double)ticks * count),
+			aosTime * 1e9 / ((double)ticks * count), aosTime / soa);
+
+		GameFree(aos);
+		DestroyEntityWorld(world);
+	}
+	return BenchAnimationKernels(50000, ticks);
+}
+
+// Move and animate fanned out over the job system, from the calling thread alone up to
+// every core. Each run must match the single-threaded result exactly.
+static int BenchJobs(int ticks)
+{
+	const int count = 200000;
+	const float dt = 1.0f / SIM_TICK_RATE;
+	int maxThreads = PlatformGetCpuCount();
+	if (maxThreads > JOB_MAX_WORKERS + 1) maxThreads = JOB_MAX_WORKERS + 1;
+
+	EntityWorld* reference = NULL;
+	double single = 0.0;
+	printf("\n---------------- Job system scaling ----------------\n");
+	printf("%8s %12s %10s %10s %8s\n", "threads", "ms/tick", "speedup", "efficiency", "matches");
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		if (threads > 1) InitJobSystem(threads - 1);
+		EntityWorld* world = CreateEntityWorld(count);
+		if (!world) return 1;
+		PopulateWorld(world, count);
+
+		double start = PlatformGetTime();
+		for (int t = 0; t < ticks; t++)
+		{
+			SaveEntityPositions(world);
+			MoveEntities(world, dt);
+			AnimateEntities(world, dt);
+		}
+		double elapsed = PlatformGetTime() - start;
+		int workers = GetJobWorkerCount();
+		ShutdownJobSystem();
+
+		bool matches = true;
+		if (!reference)
+		{
+			reference = world;
+			single = elapsed;
+		}
+		else
+		{
+			matches = memcmp(world->posX, reference->posX, sizeof(float) * count) == 0 &&
+				memcmp(world->sourceRects, reference->sourceRects, sizeof(Rectangle) * count) == 0;
+			DestroyEntityWorld(world);
+		}
+		printf("%8d %12.3f %9.2fx %9.0f%% %8s\n", workers + 1, elapsed * 1e3 / ticks, single / elapsed,
+			single / elapsed * 100.0 / (workers + 1), matches ? "yes" : "NO");
+		if (!matches) return 1;
+	}
+	DestroyEntityWorld(reference);
+	return 0;
+}
+
+// Everything from locating the assets to the end of the first frame: the title scene's
+// textures decoded (or looked up) and uploaded. The working directory is restored after
+// each run because SearchAndSetResourceDir() changes it.
+static double TimeToFirstFrame(const char* bundlePath)
+{
+	char startDir[1024];
+	snprintf(startDir, sizeof(startDir), "%s", GetWorkingDirectory());
+
+	double start = PlatformGetTime();
+	if (bundlePath)
+	{
+		if (!OpenAssetBundle(bundlePath)) return -1.0;
+	}
+	else
+	{
+		SearchAndSetResourceDir("resources");
+	}
+	InitAssetCache();
+	InitGame();
+	SampleInput();
+	TickGame();
+	PumpAssetUploads(ASSET_UPLOAD_BUDGET_MS);
+	double elapsed = PlatformGetTime() - start;
+
+	ShutdownGame();
+	UnloadAssetCache();
+	CloseAssetBundle();
+	ResetFrameArena();
+	ChangeDirectory(startDir);
+	return elapsed;
+}
+
+static int CompareDoubles(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+static int BenchStartup(const char* bundlePath, int runs)
+{
+	InitLogger();
+	SetTraceLogLevel(LOG_WARNING);
+	if (runs < 1) runs = 1;
+	if (runs > 64) runs = 64;
+
+	// Runs alternate so both paths see the same OS file cache state. The first pass of
+	// each is usually the only cold one, so it is reported on its own.
+	double loose[64];
+	double bundled[64];
+	for (int i = 0; i < runs; i++)
+	{
+		loose[i] = TimeToFirstFrame(NULL);
+		bundled[i] = TimeToFirstFrame(bundlePath);
+		if (bundled[i] < 0.0)
+		{
+			printf("Could not open asset bundle <%s>; build it with CeliseBundle first\n", bundlePath);
+			ShutdownLogger();
+			return 1;
+		}
+	}
+
+	double looseFirst = loose[0];
+	double bundledFirst = bundled[0];
+	qsort(loose, runs, sizeof(double), CompareDoubles);
+	qsort(bundled, runs, sizeof(double), CompareDoubles);
+
+	printf("\n---------------- Time to first frame ----------------\n");
+	printf("%-14s %12s %12s %12s\n", "assets", "first (ms)", "median (ms)", "best (ms)");
+	printf("%-14s %12.3f %12.3f %12.3f\n", "loose files", looseFirst * 1e3, loose[runs / 2] * 1e3, loose[0] * 1e3);
+	printf("%-14s %12.3f %12.3f %12.3f\n", "bundle", bundledFirst * 1e3, bundled[runs / 2] * 1e3, bundled[0] * 1e3);
+	printf("\nmedian speed-up %.2fx over %d runs (%s)\n", loose[runs / 2] / bundled[runs / 2], runs, bundlePath);
+
+	ShutdownLogger();
+	return 0;
+}
+
+// Each run changes only the gold, so after the first save the writer should append one
+// section and skip the rest. Serialize is what the main thread pays for a quicksave.
+static int BenchSave(int runs)
+{
+	static const char* itemKeys[] = { "iron_key", "bread", "healing_draught", "sealed_letter", "candle" };
+	const char* path = "bench_save.csav";
+	if (runs < 1) runs = 1;
+	if (runs > 256) runs = 256;
+
+	if (!StartHeadlessGame("bench/scripts/new_game.txt")) return 1;
+	for (int i = 0; i < 300; i++)
+	{
+		StepHeadlessGame(); // Into the castle
+	}
+	Inventory* inventory = &GetPlayerData()->inv;
+	for (int i = 0; inventory->freeHead >= 0; i++)
+	{
+		AddItems(inventory, FindItem(itemKeys[i % 5]), 3);
+	}
+	remove(path);
+
+	double serialize[256];
+	double write[256];
+	double load[256];
+	bool ok = true;
+	for (int i = 0; i < runs && ok; i++)
+	{
+		top_bar_context.gold = i;
+		ok = QuickSave(path);
+		WaitForSaveWriter();
+		SaveStats saved = GetSaveStats();
+		serialize[i] = saved.lastSerializeMs;
+		write[i] = saved.lastWriteMs;
+		ok = ok && LoadSave(path) && top_bar_context.gold == i;
+		load[i] = GetSaveStats().lastLoadMs;
+	}
+	if (!ok)
+	{
+		printf("Save round trip failed\n");
+		StopHeadlessGame();
+		return 1;
+	}
+
+	SaveStats total = GetSaveStats();
+	qsort(serialize, runs, sizeof(double), CompareDoubles);
+	qsort(write, runs, sizeof(double), CompareDoubles);
+	qsort(load, runs, sizeof(double), CompareDoubles);
+	printf("\n---------------- Save / load ----------------\n");
+	printf("%-28s %12s %12s\n", "", "median (ms)", "worst (ms)");
+	printf("%-28s %12.4f %12.4f\n", "serialize (main thread)", serialize[runs / 2], serialize[runs - 1]);
+	printf("%-28s %12.4f %12.4f\n", "write (writer thread)", write[runs / 2], write[runs - 1]);
+	printf("%-28s %12.4f %12.4f\n", "load (main thread)", load[runs / 2], load[runs - 1]);
+	printf("\n%lld saves: %lld sections written, %lld unchanged, %lld bytes, %lld compactions\n",
+		total.saves, total.sectionsWritten, total.sectionsSkipped, total.bytesWritten, total.compactions);
+
+	remove(path);
+	StopHeadlessGame();
+	return 0;
+}
+
+static int CountReadyVariants(int variants)
+{
+	int ready = 0;
+	for (int i = 0; i < variants; i++)
+	{
+		ready += IsTextureReady("background.png", 320 + 64 * i, 180 + 36 * i);
+	}
+	return ready;
+}
+
+// Prefetched variants nobody acquires, like the ones a window resize or a scene that is never
+// entered leaves behind, are held through the grace period, then reclaimed first
+static int BenchPrefetch(int variants)
+{
+	if (variants < 1) variants = 1;
+	if (variants > 16) variants = 16;
+	if (!StartHeadlessGame("bench/scripts/new_game.txt")) return 1;
+	for (int i = 0; i < 10; i++)
+	{
+		StepHeadlessGame();
+	}
+	CollectUnusedAssets();
+	long long budget = GetAssetCacheStats().bytesResident;
+	SetAssetBudget(budget);
+
+	for (int i = 0; i < variants; i++)
+	{
+		PrefetchTextureSized("background.png", 320 + 64 * i, 180 + 36 * i);
+	}
+	// Decoding takes wall time and these frames take none, so let every variant land first;
+	// frames only count in CollectUnusedAssets()
+	double start = PlatformGetTime();
+	while (CountReadyVariants(variants) < variants && PlatformGetTime() - start < 10.0)
+	{
+		PumpAssetUploads(ASSET_UPLOAD_BUDGET_MS);
+		PlatformSleep(0.001);
+	}
+	long long peak = GetAssetCacheStats().bytesResident;
+	int evictionsBefore = GetAssetCacheStats().evictions;
+
+	int kept = 0;
+	int frame = 0;
+	for (; frame < ASSET_PREFETCH_GRACE_FRAMES + 60; frame++)
+	{
+		CollectUnusedAssets();
+		if (frame == ASSET_PREFETCH_GRACE_FRAMES / 2) kept = CountReadyVariants(variants);
+	}
+	int left = CountReadyVariants(variants);
+	AssetCacheStats after = GetAssetCacheStats();
+
+	printf("\n---------------- Unacquired prefetches ----------------\n");
+	printf("budget             %.2f MB\n", budget / (1024.0 * 1024.0));
+	printf("with %2d variants   %.2f MB resident\n", variants, peak / (1024.0 * 1024.0));
+	printf("after %4d frames   %.2f MB resident, %d variants left, %d evictions\n",
+		frame, after.bytesResident / (1024.0 * 1024.0), left, after.evictions - evictionsBefore);
+	bool ok = kept == variants && left == 0 && after.bytesResident <= budget;
+	printf("%s\n", ok ? "OK: kept through the grace period, then reclaimed" :
+		kept < variants ? "FAILED: prefetches lost within the grace period" : "FAILED: prefetches still hold the budget");
+
+	StopHeadlessGame();
+	return ok ? 0 : 1;
+}
+
+// The layout the item database replaced: a name per slot, found by comparing strings
+typedef struct {
+	const char* name;
+	int count;
+} StringSlot;
+
+static int CountStringSlots(const StringSlot* slots, int capacity, const char* name)
+{
+	int total = 0;
+	for (int i = 0; i < capacity; i++)
+	{
+		if (slots[i].name && strcmp(slots[i].name, name) == 0) total += slots[i].count;
+	}
+	return total;
+}
+
+static bool AddStringSlot(StringSlot* slots, int capacity, const char* name, int maxStack)
+{
+	int empty = -1;
+	for (int i = 0; i < capacity; i++)
+	{
+		if (!slots[i].name)
+		{
+			if (empty < 0) empty = i;
+		}
+		else if (slots[i].count < maxStack && strcmp(slots[i].name, name) == 0)
+		{
+			slots[i].count++;
+			return true;
+		}
+	}
+	if (empty < 0) return false;
+	slots[empty] = (StringSlot){ name, 1 };
+	return true;
+}
+
+static void RemoveStringSlot(StringSlot* slots, int capacity, const char* name)
+{
+	for (int i = 0; i < capacity; i++)
+	{
+		if (slots[i].name && strcmp(slots[i].name, name) == 0)
+		{
+			if (--slots[i].count == 0) slots[i].name = NULL;
+			return;
+		}
+	}
+}
+
+static int CompareStringSlots(const void* a, const void* b)
+{
+	const StringSlot* x = (const StringSlot*)a;
+	const StringSlot* y = (const StringSlot*)b;
+	if (!x->name || !y->name) return (x->name == NULL) - (y->name == NULL);
+	int order = strcmp(x->name, y->name);
+	return order ? order : y->count - x->count;
+}
+
+// Large chest and merchant inventories, three quarters full of every item in the table.
+// Each query picks an item, counts it, then adds and removes one of it; the sort is what
+// the inventory screen does when it opens.
+static int BenchItems(int queries)
+{
+	static const int capacities[] = { 256, 1024, 4096 };
+	if (queries < 1) queries = 1;
+
+	InitItemDatabase();
+	int itemCount = GetItemCount();
+	printf("\n---------------- Inventory queries ----------------\n");
+	printf("%8s %16s %16s %10s %16s %16s\n", "slots", "indexed ns/op", "strings ns/op", "speedup", "indexed sort us", "strings sort us");
+	for (int c = 0; c < (int)(sizeof(capacities) / sizeof(capacities[0])); c++)
+	{
+		int capacity = capacities[c];
+		Inventory inventory;
+		StringSlot* strings = (StringSlot*)GameAlloc(sizeof(StringSlot) * capacity);
+		StringSlot* sorted = (StringSlot*)GameAlloc(sizeof(StringSlot) * capacity);
+		int* order = (int*)GameAlloc(sizeof(int) * capacity);
+		if (!InitInventory(&inventory, capacity) || !strings || !sorted || !order) return 1;
+
+		// Same contents in both layouts
+		for (int i = 0; inventory.usedSlots < capacity * 3 / 4; i++)
+		{
+			ItemId item = (ItemId)(1 + i % itemCount);
+			AddItems(&inventory, item, 1 + i % GetItemRecord(item)->maxStack);
+		}
+		for (int slot = 0; slot < capacity; slot++)
+		{
+			InventorySlot stack = inventory.slots[slot];
+			strings[slot] = (StringSlot){ stack.item != ITEM_NONE ? GetItemName(stack.item) : NULL, stack.count };
+		}
+
+		long long sum = 0;
+		double start = PlatformGetTime();
+		for (int q = 0; q < queries; q++)
+		{
+			ItemId item = (ItemId)(1 + (q * 7) % itemCount);
+			sum += CountItem(&inventory, item) + HasItem(&inventory, item);
+			if (AddItems(&inventory, item, 1) == 0) RemoveItems(&inventory, item, 1);
+		}
+		double indexed = PlatformGetTime() - start;
+
+		start = PlatformGetTime();
+		for (int q = 0; q < queries; q++)
+		{
+			ItemId item = (ItemId)(1 + (q * 7) % itemCount);
+			const char* name = GetItemName(item);
+			int count = CountStringSlots(strings, capacity, name);
+			sum -= count + (count > 0);
+			if (AddStringSlot(strings, capacity, name, GetItemRecord(item)->maxStack)) RemoveStringSlot(strings, capacity, name);
+		}
+		double scanned = PlatformGetTime() - start;
+
+		start = PlatformGetTime();
+		int used = GetSortedInventorySlots(&inventory, order);
+		double sortIndexed = PlatformGetTime() - start;
+
+		memcpy(sorted, strings, sizeof(StringSlot) * capacity);
+		start = PlatformGetTime();
+		qsort(sorted, capacity, sizeof(StringSlot), CompareStringSlots);
+		double sortStrings = PlatformGetTime() - start;
+
+		// Both layouts must have answered the same
+		if (sum != 0 || used != inventory.usedSlots)
+		{
+			printf("Indexed and string inventories disagree at %d slots\n", capacity);
+			return 1;
+		}
+		printf("%8d %16.1f %16.1f %9.2fx %16.1f %16.1f\n", capacity, indexed * 1e9 / queries, scanned * 1e9 / queries,
+			scanned / indexed, sortIndexed * 1e6, sortStrings * 1e6);
+
+		FreeInventory(&inventory);
+		GameFree(order);
+		GameFree(sorted);
+		GameFree(strings);
+	}
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--ecs") == 0)
+	{
+		return BenchEntities(argc > 2 ? atoi(argv[2]) : 1000);
+	}
+	if (argc > 1 && strcmp(argv[1], "--startup") == 0)
+	{
+		return BenchStartup(argc > 2 ? argv[2] : ASSET_BUNDLE_FILE, argc > 3 ? atoi(argv[3]) : 10);
+	}
+	if (argc > 1 && strcmp(argv[1], "--save") == 0)
+	{
+		return BenchSave(argc > 2 ? atoi(argv[2]) : 100);
+	}
+	if (argc > 1 && strcmp(argv[1], "--jobs") == 0)
+	{
+		return BenchJobs(argc > 2 ? atoi(argv[2]) : 200);
+	}
+	if (argc > 1 && strcmp(argv[1], "--items") == 0)
+	{
+		return BenchItems(argc > 2 ? atoi(argv[2]) : 100000);
+	}
+	if (argc > 1 && strcmp(argv[1], "--prefetch") == 0)
+	{
+		return BenchPrefetch(argc > 2 ? atoi(argv[2]) : 8);
+	}
+
+	int ticks = argc > 1 ? atoi(argv[1]) : 100000;
+	const char* scriptPath = argc > 2 ? argv[2] : "bench/scripts/new_game.txt";
+
+	if (!StartHeadlessGame(scriptPath)) return 1;
+
+	AllocStats allocsBefore = GetAllocStats();
+	double start = PlatformGetTime();
+	for (int i = 0; i < ticks; i++)
+	{
+		StepHeadlessGame();
+	}
+	double elapsed = PlatformGetTime() - start;
+	AllocStats allocsAfter = GetAllocStats();
+
+	printf("\n---------------- Scene loop benchmark ----------------\n");
+	printf("ticks           %d\n", ticks);
+	printf("wall time       %.3f s\n", elapsed);
+	printf("ticks/sec       %.0f\n", ticks / elapsed);
+	printf("mean tick       %.3f us\n", elapsed * 1e6 / ticks);
+
+	printf("\nper-scene Update cost\n");
+	const SceneUpdateTiming* timings = NULL;
+	int timingCount = GetSceneUpdateTimings(&timings);
+	for (int i = 0; i < timingCount; i++)
+	{
+		if (timings[i].ticks == 0) continue;
+		printf("  %-24s %10lld ticks %10.3f ms total %8.3f us/tick\n", timings[i].scene_name, timings[i].ticks,
+			timings[i].seconds * 1e3, timings[i].ticks ? timings[i].seconds * 1e6 / timings[i].ticks : 0.0);
+	}
+
+	long long allocations = allocsAfter.allocations - allocsBefore.allocations;
+	printf("\nheap allocations %lld (%lld frees, %lld bytes, %.4f per tick)\n", allocations,
+		allocsAfter.frees - allocsBefore.frees, allocsAfter.bytesAllocated - allocsBefore.bytesAllocated,
+		(double)allocations / ticks);
+
+	LogAssetCacheStats();
+	StopHeadlessGame();
+	return 0;
+}
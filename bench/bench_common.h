@@ -0,0 +1,62 @@
+#pragma once
+
+#include "raylib.h"
+#include "resource_dir.h"
+#include "asset_cache.h"
+#include "bundle.h"
+#include "input.h"
+#include "simulation.h"
+#include "game.h"
+#include "arena.h"
+#include "logger.h"
+#include "profiler.h"
+#include "save.h"
+#include "jobs.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Shared start-up for the headless executables, finding assets the way the game does.
+// The script is loaded before SearchAndSetResourceDir() so its path is relative to
+// where the tool was started.
+static inline bool StartHeadlessGame(const char* scriptPath)
+{
+	InitLogger();
+	PROFILE_THREAD_NAME("main");
+	SetTraceLogLevel(LOG_WARNING);
+	if (!LoadInputScript(scriptPath))
+	{
+		DebugLog(LOG_ERROR, "Could not read input script <%s>", scriptPath);
+		ShutdownLogger(); // Flushes the error, the caller exits right away
+		return false;
+	}
+
+	if (!OpenInstalledAssetBundle()) SearchAndSetResourceDir("resources");
+	InitAssetCache();
+	InitSimulationClock(SIM_TICK_RATE);
+	InitJobSystem(0);
+	InitGame();
+	InitSaveSystem();
+	return true;
+}
+
+// One simulated frame: exactly one tick, no rendering
+static inline void StepHeadlessGame(void)
+{
+	SampleInput();
+	StepSimulationClock();
+	TickGame();
+	PumpAssetUploads(ASSET_UPLOAD_BUDGET_MS);
+	CollectUnusedAssets();
+	ResetFrameArena();
+	PROFILE_FRAME();
+}
+
+static inline void StopHeadlessGame(void)
+{
+	ShutdownSaveSystem();
+	ShutdownGame();
+	ShutdownJobSystem();
+	UnloadAssetCache();
+	CloseAssetBundle();
+	ShutdownLogger();
+}
@@ -0,0 +1,49 @@
+#include "bench_common.h"
+
+// Runs the update path with no window against a scripted input stream and prints a
+// trace once per simulated second. The trace only depends on the script and the tick
+// rate, so two runs (or two commits) can be diffed to check the simulation is deterministic.
+//
+// Usage: CeliseHeadless [script] [ticks] [trace.json]
+// With a third argument the last frames' profiler zones are written there as a Chrome trace.
+
+static unsigned int HashTrace(unsigned int hash, const char* line)
+{
+	for (const unsigned char* c = (const unsigned char*)line; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+int main(int argc, char** argv)
+{
+	const char* scriptPath = argc > 1 ? argv[1] : "bench/scripts/new_game.txt";
+	int ticks = argc > 2 ? atoi(argv[2]) : 1500;
+
+	if (!StartHeadlessGame(scriptPath)) return 1;
+
+	unsigned int hash = 2166136261u;
+	for (int tick = 1; tick <= ticks; tick++)
+	{
+		StepHeadlessGame();
+		if (tick % SIM_TICK_RATE != 0 && tick != ticks) continue;
+
+		Scene* scene = GetFocusScene(globalSceneStack);
+		Player* player = GetPlayer();
+		Vector2 position = GetPlayerPosition(player);
+		long long minutes = GetGameMinutes();
+		char line[192];
+		snprintf(line, sizeof(line), "tick %6d  scene %-24s  player %8.2f %8.2f  frame %d  clock %lld %02lld:%02lld%s",
+			tick, scene ? scene->scene_name : "<none>", position.x, position.y,
+			GetPlayerFrame(player), minutes / (24 * 60), minutes / 60 % 24, minutes % 60, player->isRunning ? "  running" : "");
+		hash = HashTrace(hash, line);
+		printf("%s\n", line);
+	}
+	printf("trace hash %08x\n", hash);
+	if (argc > 3) ExportProfilerTrace(argv[3]);
+
+	StopHeadlessGame();
+	return 0;
+}
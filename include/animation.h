@@ -0,0 +1,115 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include "ecs.h"
+#include <stdint.h>
+
+#define ANIMATION_MAX_FRAMES 64 // Per set
+#define ANIMATION_MAX_SHEETS 4
+#define ANIMATION_MAX_PATH 64
+#define ANIMATION_MAX_SETS 16
+
+// Sprite-sheet animation described by data instead of code. A set is authored as a text
+// spec (.anim) next to its sheets in resources/:
+//
+//   # cells are <width> x <height> in a horizontal strip starting at the sheet's left edge
+//   cell 180 220
+//   # clip <state> <sheet> <first cell> <cells> <ms per frame, 0 holds> [once]
+//   clip idle    character/walking_sprite_sheet.png 1 1 0
+//   clip walking character/walking_sprite_sheet.png 0 6 100
+//
+// CeliseBundle bakes each spec into a BUNDLE_CLIPS entry: the same clips, but every frame
+// trimmed to the pixels that are not fully transparent, with the trimmed rectangle's
+// offset inside its cell. Run from loose files, the spec is read as it is and frames are
+// drawn untrimmed. Either way the sheets are looked up in the atlas the set is loaded with.
+//
+// The entity's position is the top-left of its cell, and frameWidth/frameHeight stay the
+// cell size, so bounds, culling and gameplay see the same box trimmed or not.
+
+// ------ Baked format (BUNDLE_CLIPS payload, little-endian) ------
+// ClipSetHeader, sheetCount paths of ANIMATION_MAX_PATH bytes, clipCount ClipRecord,
+// frameCount ClipFrameRecord
+
+typedef struct {
+	uint16_t cellWidth;
+	uint16_t cellHeight;
+	uint16_t sheetCount;
+	uint16_t clipCount;
+	uint16_t frameCount;
+	uint16_t reserved[3];
+} ClipSetHeader;
+
+typedef struct {
+	uint8_t state; // EntityState
+	uint8_t sheet;
+	uint8_t loop;
+	uint8_t reserved;
+	uint16_t firstFrame;
+	uint16_t frameCount;
+} ClipRecord;
+
+typedef struct {
+	uint16_t x; // Trimmed rectangle in the sheet
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+	int16_t offsetX; // Of the trimmed rectangle from the top-left of its cell
+	int16_t offsetY;
+	uint16_t durationMs;
+	uint16_t reserved;
+} ClipFrameRecord;
+
+// ------ Spec (.anim), shared with CeliseBundle ------
+
+typedef struct {
+	EntityState state;
+	char sheet[ANIMATION_MAX_PATH];
+	int firstCell;
+	int cellCount;
+	int durationMs;
+	bool loop;
+} AnimationSpecClip;
+
+typedef struct {
+	int cellWidth;
+	int cellHeight;
+	int clipCount;
+	AnimationSpecClip clips[ENTITY_STATE_COUNT];
+} AnimationSpec;
+
+extern const char* const entityStateNames[ENTITY_STATE_COUNT]; // As spelled in specs
+
+// Returns false and describes the first problem in error
+bool ParseAnimationSpec(const char* text, AnimationSpec* spec, char* error, int errorSize);
+
+// ------ Runtime ------
+
+typedef struct {
+	Rectangle source; // In the atlas texture, trimmed when baked
+	Vector2 offset; // Of source from the top-left of its cell
+	float duration; // Seconds, 0 holds the frame
+} AnimationFrame;
+
+typedef struct {
+	unsigned short firstFrame;
+	unsigned short frameCount;
+	bool loop; // Otherwise holds the last frame
+} AnimationClip;
+
+struct AnimationSet {
+	Texture2D texture;
+	Vector2 cellSize;
+	AnimationClip clips[ENTITY_STATE_COUNT]; // States without a clip of their own play idle's
+	int frameCount;
+	AnimationFrame frames[ANIMATION_MAX_FRAMES];
+	bool trimmed;
+};
+
+// Shared by path (the .anim spec), like assets; NULL if it cannot be loaded
+const AnimationSet* AcquireAnimationSet(const char* path, const TextureAtlas* atlas);
+void ReleaseAnimationSet(const AnimationSet* set);
+
+// The entity then plays the clip of its state (AnimateEntities), drawn from set's texture.
+// NULL hands it back to the strip fields (sheetX, frameCount, ...).
+void SetEntityAnimation(EntityWorld* world, EntityId entity, const AnimationSet* set);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#define FRAME_ARENA_SIZE (64 * 1024)
+#define SCENE_ARENA_SIZE (16 * 1024)
+
+// Bump allocator over one block taken from GameAlloc() up front. Allocations are
+// never freed one by one; the whole arena is reset (frame arena, after EndDrawing)
+// or destroyed (scene arenas, in the scene's Free callback). Running out returns
+// NULL and is counted rather than falling back to the heap.
+
+typedef struct {
+	const char* name;
+	unsigned char* base;
+	size_t capacity;
+	size_t used;
+	size_t highWater; // Most bytes in use at once since creation
+	long long overflows;
+	unsigned int resets; // Bumped by ResetArena, so caches can tell frames apart
+} Arena;
+
+Arena* CreateArena(const char* name, size_t capacity);
+void DestroyArena(Arena* arena);
+void* ArenaAlloc(Arena* arena, size_t size);
+char* ArenaPrintf(Arena* arena, const char* format, ...);
+char* ArenaStrdup(Arena* arena, const char* text);
+void ResetArena(Arena* arena);
+
+// The per-frame arena: anything allocated from it is valid until the end of the current frame
+bool InitFrameArena(void);
+Arena* GetFrameArena(void);
+void ResetFrameArena(void);
+void ShutdownFrameArena(void);
+void LogArenaStats(const Arena* arena);
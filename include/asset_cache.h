@@ -0,0 +1,127 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include <stdio.h>
+
+#define MAX_CACHED_ASSETS 64
+#define MAX_ASSET_PATH 128
+#define ASSET_UPLOAD_BUDGET_MS 2.0
+#define ASSET_DEFAULT_VRAM_BUDGET (128ll * 1024 * 1024) // Bytes of textures kept resident, see SetAssetBudget()
+#define ASSET_MAX_SCOPES 32 // Scene ids, for per-scene footprints
+#define ASSET_PREFETCH_GRACE_FRAMES 600 // A prefetch nobody acquired is evictable after this many frames
+
+// How TTF/OTF fonts are rasterized; CeliseBundle bakes them the same way. The glyph set is
+// printable ASCII plus Latin-1, so names like "Célise" render.
+#define FONT_BASE_SIZE 32
+#define FONT_GLYPH_COUNT 191
+#define FONT_GLYPH_PADDING 4
+#define FONT_SDF_SIZE 48 // Distance field fonts are baked once at this size and scaled when drawn
+#define FONT_BAKED_SIZES { 20, 24, 32 } // Sizes the game draws text at, pre-baked by CeliseBundle
+
+// Reference-counted texture/font cache keyed by resource path.
+// Every scene acquires its assets through here instead of calling LoadTexture/LoadFont
+// directly, so two scenes sharing an image share one decode and one GPU upload.
+// Assets whose count drops to zero stay resident, so going back to a scene that was just
+// popped costs nothing. CollectUnusedAssets() runs at the end of the frame and only evicts
+// them, least recently used first, once the resident textures exceed the VRAM budget.
+// Prefetches nobody acquired within ASSET_PREFETCH_GRACE_FRAMES go before those.
+//
+// Decoding (PNG -> Image, TTF -> glyphs + atlas image) runs on a worker thread. Only the
+// GPU upload happens on the main thread, inside PumpAssetUploads() under a time budget.
+// Acquiring an asset that is still in flight finishes it immediately (counted as a stall).
+// Atlases are cached under their AtlasDesc name and packed on the worker as well.
+// When an asset bundle is open (bundle.h), images and fonts come from it and skip decoding.
+//
+// ReloadAssetFile() re-decodes every resident asset made from a file that changed (see
+// hot_reload.h), on the worker as well. PumpAssetUploads() then writes the new pixels into
+// the existing textures, so handles scenes already hold pick the change up.
+
+typedef struct {
+	int hits;
+	int misses;
+	int stalls;
+	int textureCount;
+	int fontCount;
+	int reloads;
+	int evictions;
+	long long bytesResident; // Texture memory, mip chains, fonts and atlases included
+	long long bytesUnused; // Part of bytesResident nobody holds, first to be evicted
+	long long budget;
+} AssetCacheStats;
+
+// Assets a scene expects its successor to need, so they can be decoded ahead of time
+typedef struct {
+	const char** textures;
+	int textureCount;
+	const char** fonts;
+	int fontCount;
+	const AtlasDesc** atlases;
+	int atlasCount;
+} AssetManifest;
+
+void InitAssetCache(void);
+void UnloadAssetCache(void);
+
+Texture2D AcquireTexture(const char* path);
+// path scaled to exactly width x height on the decode worker, and mipmapped when that is
+// smaller than the source. Cached apart from the plain image (see ScreenTexture).
+Texture2D AcquireTextureSized(const char* path, int width, int height);
+Font AcquireFont(const char* path); // Baked at FONT_BASE_SIZE
+// Baked at exactly size pixels, or as a FONT_SDF_SIZE distance field (size is then ignored)
+Font AcquireFontEx(const char* path, int size, bool sdf);
+const TextureAtlas* AcquireAtlas(const AtlasDesc* desc);
+void ReleaseTexture(Texture2D texture);
+void ReleaseFont(Font font);
+void ReleaseAtlas(const TextureAtlas* atlas);
+// Every texel has full alpha, so drawing it untinted needs no blending. False for textures
+// the cache does not own.
+bool IsTextureOpaque(Texture2D texture);
+const TextureAtlas* FindTextureAtlas(Texture2D texture); // The cached atlas drawn from texture, or NULL
+
+void PrefetchTexture(const char* path);
+bool PrefetchTextureSized(const char* path, int width, int height); // False if the cache is full
+bool IsTextureReady(const char* path, int width, int height); // Acquiring it would not stall
+void PrefetchFont(const char* path);
+void PrefetchFontEx(const char* path, int size, bool sdf);
+void PrefetchAtlas(const AtlasDesc* desc);
+void PrefetchAssets(const AssetManifest* manifest);
+void PumpAssetUploads(double budgetMs);
+int ReloadAssetFile(const char* file); // Main thread; returns how many assets use the file
+
+void CollectUnusedAssets(void);
+void SetAssetBudget(long long bytes);
+
+// Assets acquired between BeginAssetScope() and EndAssetScope() are attributed to scope
+// (a SceneId, see LoadScene()). An asset can belong to several scopes, and keeps them
+// until it is evicted.
+void BeginAssetScope(void);
+void EndAssetScope(int scope);
+long long GetAssetScopeBytes(int scope);
+
+AssetCacheStats GetAssetCacheStats(void);
+void LogAssetCacheStats(void);
+
+static inline void GetFontCodepoints(int* codepoints)
+{
+	int count = 0;
+	for (int c = 32; c < 127; c++) codepoints[count++] = c;
+	for (int c = 160; c < 256; c++) codepoints[count++] = c;
+}
+
+// Cache key of a texture scaled to another size: "<path>#<width>x<height>". The plain
+// image keeps the plain path.
+static inline void FormatSizedTextureKey(char* key, int keySize, const char* path, int width, int height)
+{
+	if (width > 0 && height > 0) snprintf(key, keySize, "%s#%dx%d", path, width, height);
+	else snprintf(key, keySize, "%s", path);
+}
+
+// Cache (and bundle) key of a font baked at another size: "<path>@<size>" or "<path>@sdf".
+// The default bake keeps the plain path.
+static inline void FormatFontKey(char* key, int keySize, const char* path, int size, bool sdf)
+{
+	if (sdf) snprintf(key, keySize, "%s@sdf", path);
+	else if (size != FONT_BASE_SIZE) snprintf(key, keySize, "%s@%d", path, size);
+	else snprintf(key, keySize, "%s", path);
+}
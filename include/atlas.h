@@ -0,0 +1,44 @@
+#pragma once
+
+#include "raylib.h"
+
+#define ATLAS_MAX_REGIONS 32
+#define ATLAS_PADDING 2
+#define ATLAS_MAX_SIZE 4096
+#define ATLAS_MAX_NAME 128
+
+// Several small images packed into one texture at load time, so everything drawn from
+// them can go out in a single draw call. Atlases are built and shared through the asset
+// cache: packing runs on the decode worker, the upload happens like any other texture.
+
+typedef struct {
+	const char* name;   // Cache key, e.g. "sprites"
+	const char** paths; // Member images
+	int count;
+} AtlasDesc;
+
+typedef struct {
+	unsigned int hash;
+	char name[ATLAS_MAX_NAME];
+	Rectangle rect;
+	bool opaque; // Every pixel has full alpha
+} AtlasRegion;
+
+typedef struct {
+	Texture2D texture;
+	int regionCount;
+	AtlasRegion regions[ATLAS_MAX_REGIONS];
+} TextureAtlas;
+
+// CPU half of the build: loads every member and packs them into one RGBA image.
+// Safe to call off the main thread.
+bool PackAtlasImage(const AtlasDesc* desc, Image* outImage, TextureAtlas* outAtlas);
+
+Rectangle GetAtlasRegion(const TextureAtlas* atlas, const char* path);
+bool IsAtlasRegionOpaque(const TextureAtlas* atlas, const char* path);
+// source (flipped or not) lies inside one region whose pixels all have full alpha
+bool IsAtlasSourceOpaque(const TextureAtlas* atlas, Rectangle source);
+
+// True if every pixel has full alpha; only RGBA8 is scanned, other formats with alpha are
+// taken as not opaque
+bool IsImageOpaque(const Image* image);
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "raylib.h"
+#include <stdint.h>
+
+#define ASSET_BUNDLE_FILE "celise.bundle"
+#define BUNDLE_MAGIC 0x4C444E42u // "BNDL"
+#define BUNDLE_VERSION 1
+#define BUNDLE_ALIGNMENT 16
+#define BUNDLE_MAX_PATH 128
+
+// One file holding every asset in resources/, already decoded, written by the
+// CeliseBundle tool (tools/bundle_packer.c). The game maps it read-only: loading an
+// asset is an index lookup, and the pixels are handed to the GPU straight from the
+// mapping without a PNG decode or an intermediate copy.
+//
+// Layout (little-endian): BundleHeader, entryCount BundleEntry records sorted by hash,
+// then the payloads, each starting on a BUNDLE_ALIGNMENT boundary.
+//   BUNDLE_IMAGE: width * height pixels in pixelFormat (always RGBA8 from the packer)
+//   BUNDLE_FONT:  glyphCount BundleGlyph records, then the glyph atlas pixels
+//   BUNDLE_CLIPS: an animation spec baked with trimmed frames (animation.h), keyed by
+//                 the .anim path
+
+typedef enum {
+	BUNDLE_IMAGE = 1,
+	BUNDLE_FONT = 2,
+	BUNDLE_CLIPS = 3
+} BundleFormat;
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+} BundleHeader;
+
+typedef struct {
+	uint32_t hash; // HashBundlePath(path)
+	uint32_t format; // BundleFormat
+	uint64_t offset; // From the start of the file
+	uint64_t size;
+	int32_t width; // Of the image, or of the font's glyph atlas
+	int32_t height;
+	int32_t pixelFormat; // raylib PixelFormat
+	int32_t glyphCount; // Fonts only
+	int32_t baseSize;
+	int32_t glyphPadding;
+	char path[BUNDLE_MAX_PATH]; // Relative to resources/, '/' separated
+} BundleEntry;
+
+typedef struct {
+	int32_t value; // Codepoint
+	int32_t offsetX;
+	int32_t offsetY;
+	int32_t advanceX;
+	float x; // Rectangle in the glyph atlas
+	float y;
+	float width;
+	float height;
+} BundleGlyph;
+
+// FNV-1a, shared by the packer and the runtime lookup
+static inline uint32_t HashBundlePath(const char* path)
+{
+	uint32_t hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)path; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Opening replaces any bundle already open. The bundle must stay open while the asset
+// cache holds images decoded from it, so close it after UnloadAssetCache().
+bool OpenAssetBundle(const char* path);
+// ASSET_BUNDLE_FILE from the working directory, else from next to the executable
+bool OpenInstalledAssetBundle(void);
+void CloseAssetBundle(void);
+bool IsAssetBundleOpen(void);
+const BundleEntry* FindBundleEntry(const char* path);
+
+// The image points into the mapping: upload or copy it, never UnloadImage() it
+bool GetBundleImage(const char* path, Image* image);
+// Fills everything but the texture. Glyphs and recs are allocated with MemAlloc and owned
+// by the caller, as LoadFontData's are; the atlas image is borrowed like GetBundleImage's.
+bool GetBundleFont(const char* path, Font* font, Image* atlas);
+// Points into the mapping; NULL if path was not baked
+const void* GetBundleClips(const char* path, uint64_t* size);
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "raylib.h"
+#include "entity.h"
+
+#define ENTITY_INDEX_BITS 20
+#define ENTITY_INDEX_MASK ((1u << ENTITY_INDEX_BITS) - 1)
+#define ENTITY_GENERATION_MASK ((1u << (32 - ENTITY_INDEX_BITS)) - 1)
+#define NULL_ENTITY 0u
+#define ENTITY_JOB_GRAIN 4096 // Entities per job when a system fans out (jobs.h); smaller worlds update inline
+
+// EntityWorld.flags
+#define ENTITY_FLAG_INTERACTABLE (1u << 0) // Shows the interact prompt when the player is close
+
+typedef struct AnimationSet AnimationSet; // animation.h
+
+// Clip playback of an entity driven by an AnimationSet
+typedef struct {
+	const AnimationSet* set; // NULL for entities animated by the strip fields
+	float timer;
+	unsigned short frame; // Within the clip
+	unsigned char clipState; // EntityState the clip was started for
+} AnimationState;
+
+// EntityId (entity.h) packs a slot index with a generation counter, so an id held past
+// DespawnEntity() is detected as stale instead of aliasing whatever reused the slot.
+
+// Struct-of-arrays entity storage. Every live entity has every component, stored densely
+// in [0, count) so systems walk contiguous memory; despawning swaps the last entity into
+// the hole. ids[i] tells which entity owns dense slot i.
+typedef struct {
+	int capacity;
+	int count;
+
+	EntityId* ids;
+	float* posX;
+	float* posY;
+	float* prevX; // Position at the start of the tick, for render interpolation
+	float* prevY;
+	float* velX; // Pixels per second
+	float* velY;
+	float* animTimer;
+	float* frameTime;
+	int* animFrame;
+	int* frameCount;
+	float* direction;     // 1 for left, -1 for right, like the sprite sheets
+	unsigned char* state; // EntityState
+
+	// Where the current animation's frames sit in the texture, and the source
+	// rectangle AnimateEntities() derives from it for the sprite batch
+	float* sheetX;
+	float* sheetY;
+	float* frameWidth;
+	float* frameHeight;
+	Rectangle* sourceRects;
+	Texture2D* textures; // Drawn by DrawVisibleEntities(); id 0 means not drawn
+	unsigned char* flags;
+
+	// Entities with an AnimationSet play clips of trimmed frames instead, drawn at
+	// spriteRects (relative to the position) rather than over the whole frame
+	AnimationState* animations;
+	Rectangle* spriteRects;
+	int animatedCount; // With a set; the clip pass is skipped while there are none
+
+	const char** names; // Cold, debug only
+
+	// Sparse side: slot index -> dense index (-1 when free) and current generation
+	int* denseOf;
+	unsigned short* generations;
+	int* freeSlots;
+	int freeCount;
+	int nextSlot;
+} EntityWorld;
+
+EntityWorld* CreateEntityWorld(int capacity);
+void DestroyEntityWorld(EntityWorld* world);
+
+EntityId SpawnEntity(EntityWorld* world, Vector2 position, const char* name);
+void DespawnEntity(EntityWorld* world, EntityId entity);
+bool IsEntityAlive(const EntityWorld* world, EntityId entity);
+int GetEntityIndex(const EntityWorld* world, EntityId entity); // Dense index, or -1
+
+// Systems, in the order TickGame runs them. Move and animate split the dense range
+// across the job workers; each entity is written by one job, so results do not depend
+// on the worker count.
+void SaveEntityPositions(EntityWorld* world);
+void MoveEntities(EntityWorld* world, float dt);
+void AnimateEntities(EntityWorld* world, float dt); // Advances frames and fills sourceRects (and spriteRects)
+
+// Batches the entities in the camera's view, interpolated by alpha (ecs_render.c)
+typedef struct SpatialHash SpatialHash;
+int DrawVisibleEntities(const EntityWorld* world, const SpatialHash* hash, Camera2D camera, float alpha);
+
+// AnimateEntities() uses the widest kernel the CPU supports, picked on first use.
+// Forcing one is for benchmarks and for checking the vector paths against the scalar one.
+typedef enum {
+	ANIMATION_KERNEL_SCALAR,
+	ANIMATION_KERNEL_SSE2,
+	ANIMATION_KERNEL_AVX2
+} AnimationKernel;
+
+AnimationKernel SetAnimationKernel(AnimationKernel kernel); // Returns the kernel actually used
+const char* GetAnimationKernelName(AnimationKernel kernel);
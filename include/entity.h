@@ -0,0 +1,43 @@
+#pragma once
+
+#include "raylib.h"
+#include "inventory.h"
+
+// Per-entity data lives in the component arrays of EntityWorld (ecs.h); the structs
+// here only hold gameplay data that is not touched by per-tick systems.
+
+typedef unsigned int EntityId;
+
+typedef enum
+{
+	IDLE,
+	WALKING,
+	RUNNING,
+	JUMPING,
+	TALKING,
+	CROUCHING,
+	ATTACKING,
+	ENTITY_STATE_COUNT
+} EntityState;
+
+typedef struct {
+	int STRENGTH;
+	int CHARISMA;
+	int WISDOM;
+	int INTELLIGENCE;
+	int DEXTERITY;
+	int VITALITY;
+} Attributes;
+
+typedef struct {
+	EntityId entity;
+	Texture2D characterPortrait;
+	char* charName;
+	int charHeight;
+	int charWeight;
+} Character;
+
+typedef struct {
+	Character character;
+	Inventory inv;
+} Player_2;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "scene.h"
+#include "player.h"
+#include "atlas.h"
+#include "ecs.h"
+#include "spatial_hash.h"
+
+#define GAME_WIDTH 1280
+#define GAME_HEIGHT 720
+#define MAX_ENTITIES 1024
+#define CHARACTER_NAME_MAX 32
+#define INVENTORY_SLOTS 24
+
+// Everything between "window is open" and "window closes": the scene stack (HUD included) and
+// player. The windowed executable and the headless/benchmark executables all drive
+// the game through these calls, so they exercise exactly the same update path.
+
+typedef struct {
+	const char* scene_name;
+	long long ticks;
+	double seconds;
+} SceneUpdateTiming;
+
+// Everything the HUD and characters draw, packed so they render in one draw call
+extern const AtlasDesc spriteAtlas;
+
+void InitGame(void);
+void TickGame(void); // One fixed simulation step
+void RenderGame(void);
+void ShutdownGame(void);
+
+// Logical screen size. Headless builds have no window, so they report GAME_WIDTH x GAME_HEIGHT.
+int GetGameWidth(void);
+int GetGameHeight(void);
+
+EntityWorld* GetEntityWorld(void);
+SpatialHash* GetSpatialHash(void); // Rebuilt at the end of every tick
+Player* GetPlayer(void);
+Player_2* GetPlayerData(void); // Character sheet and inventory; charName is a CHARACTER_NAME_MAX buffer
+Attributes* GetPlayerAttributes(void);
+
+// In-game clock: one real second is one minute, a new game starts on day 1 at 06:00
+long long GetGameMinutes(void);
+void SetGameMinutes(long long minutes);
+int GetSceneUpdateTimings(const SceneUpdateTiming** timings); // Indexed by SceneId, unused scenes have 0 ticks
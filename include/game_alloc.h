@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+
+// Counting wrappers around the C heap. Game code allocates through these so the
+// benchmark can report how many heap allocations a run of frames actually made.
+
+typedef struct {
+	long long allocations;
+	long long frees;
+	long long bytesAllocated;
+} AllocStats;
+
+void* GameAlloc(size_t size);
+void* GameRealloc(void* ptr, size_t size);
+void GameFree(void* ptr);
+
+AllocStats GetAllocStats(void);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+
+#define HOT_RELOAD_SETTLE_MS 100.0 // Editors often write a file in several steps
+#define HOT_RELOAD_MAX_PENDING 32
+
+// Development aid: a thread watches the loose resource directory, and textures, fonts and
+// atlases made from a file that changes are decoded again and re-uploaded in place while
+// the game runs (ReloadAssetFile()). Nothing is watched when assets come from the bundle.
+// The watcher runs on Windows and Linux; elsewhere StartHotReload() fails.
+
+bool StartHotReload(const char* directory);
+void StopHotReload(void);
+// Main thread, once a frame after PumpAssetUploads(): hands settled changes to the asset
+// cache and invalidates the cached layers and text layouts drawn from reloaded assets
+void PumpHotReload(void);
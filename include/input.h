@@ -0,0 +1,66 @@
+#pragma once
+
+#include "raylib.h"
+
+// Input sampled once per rendered frame and read by every simulation tick.
+// Devices are only read here: the rest of the game asks for actions, which the binding
+// table in input.c maps to keys and buttons.
+// Held actions are plain state; presses are latched until a tick consumes them, so a
+// press lands exactly once whether the frame runs zero, one or several ticks.
+
+typedef enum {
+	ACTION_MOVE_LEFT,
+	ACTION_MOVE_RIGHT,
+	ACTION_RUN,
+	ACTION_CONFIRM,
+	ACTION_NAV_DOWN,
+	ACTION_CLICK,
+	// Read by the main loop once per frame with TakeFramePress(), not by ticks
+	ACTION_TOGGLE_FRAME_STATS,
+	ACTION_TOGGLE_PROFILER,
+	ACTION_EXPORT_TRACE,
+	ACTION_CYCLE_DRAW_VIEW,
+	ACTION_QUICKSAVE,
+	ACTION_QUICKLOAD,
+	ACTION_COUNT
+} InputAction;
+
+typedef struct {
+	bool down[ACTION_COUNT];
+	bool pressed[ACTION_COUNT]; // Since the last tick
+	bool anyKey; // Pressed since the last tick
+	Vector2 pointer;
+} InputState;
+
+typedef struct {
+	long long events; // Presses and holds that reached the screen
+	double lastMs;
+	double averageMs; // Recent, smoothed
+	double worstMs;
+} InputLatencyStats;
+
+// Reads the devices into the snapshot. Call right after EndDrawing(), which polls them,
+// so no press is lost, and through LatchInput() right before the simulation.
+void SampleInput(void);
+// Polls the devices again and samples: the ticks that follow see what arrived while the
+// last frame was finishing instead of a frame later
+void LatchInput(void);
+void ConsumeInputPresses(void); // After each tick
+bool TakeFramePress(InputAction action);
+const InputState* GetInput(void);
+
+// Every press and hold is timestamped when a sample first sees it. The ticks that consume
+// it mark it, and NoteFramePresented() turns the marked events into event-to-present
+// latency. The timestamp is the poll that saw the event, so the true latency can be up to
+// one poll interval higher.
+void NoteFramePresented(void);
+InputLatencyStats GetInputLatencyStats(void);
+
+#if defined(CELISE_HEADLESS)
+// Headless builds read a scripted stream instead of devices, one SampleInput() per tick.
+// One event per line: "<tick>[-<endTick>] <action> [x y]", '#' starts a comment.
+// Held actions: left, right, run. Presses (fire on the first tick): any, confirm, down, click.
+// "pointer x y" moves the pointer for the range.
+bool LoadInputScript(const char* path);
+void SetInputScript(const char* text);
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "items.h"
+#include <stdbool.h>
+
+#define INVENTORY_MAX_CAPACITY 65535 // Slot numbers are 16 bits in the sort keys
+
+// A fixed number of (item, count) slots. An index keyed by ItemId keeps each item's
+// total and the chain of slots that hold it, so counting, checking and adding or
+// removing items never scans the slots.
+//
+// All stacks of an item are full except at most one, the head of its chain: adding tops
+// that one up before taking free slots, removing takes from it first.
+
+typedef struct {
+	ItemId item; // ITEM_NONE when the slot is empty
+	unsigned short count;
+} InventorySlot;
+
+typedef struct {
+	ItemId item; // ITEM_NONE when unused
+	unsigned short reserved;
+	int total;
+	int head; // First slot of the item's chain
+} InventoryIndexEntry;
+
+typedef struct {
+	InventorySlot* slots; // What the UI shows, in slot order
+	int capacity;
+	int usedSlots;
+	int freeHead; // -1 when full
+	int* links; // Per slot: next slot of the same item, or next free slot; -1 ends a chain
+	InventoryIndexEntry* index; // Open addressing, linear probing
+	unsigned int indexMask;
+	unsigned long long* sortKeys; // Scratch for GetSortedInventorySlots
+} Inventory;
+
+// Everything lives in one GameAlloc block; on failure the inventory has no slots
+bool InitInventory(Inventory* inventory, int capacity);
+void FreeInventory(Inventory* inventory);
+void ClearInventory(Inventory* inventory);
+// Call after writing slots[] directly, e.g. when loading. False, and an empty
+// inventory, if a slot holds an unknown item or breaks the stacking rules above.
+bool RebuildInventory(Inventory* inventory);
+
+int AddItems(Inventory* inventory, ItemId item, int count); // Returns how many did not fit
+int RemoveItems(Inventory* inventory, ItemId item, int count); // Returns how many were removed
+int CountItem(const Inventory* inventory, ItemId item);
+bool HasItem(const Inventory* inventory, ItemId item);
+
+// Fills order with the used slots, by item category and name, then fullest stack first.
+// order needs room for capacity entries; returns how many were written.
+int GetSortedInventorySlots(Inventory* inventory, int* order);
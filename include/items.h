@@ -0,0 +1,46 @@
+#pragma once
+
+#define MAX_ITEMS 256
+#define ITEM_NONE 0
+
+// Every item the game knows about, built once at start-up from the table in items.c.
+// Gameplay code refers to items by ItemId, a small integer interned from the item's key,
+// and never touches a string: names are for the UI, keys for files and authoring.
+
+typedef unsigned short ItemId;
+
+typedef enum {
+	ITEM_CATEGORY_KEY,
+	ITEM_CATEGORY_WEAPON,
+	ITEM_CATEGORY_CONSUMABLE,
+	ITEM_CATEGORY_DOCUMENT,
+	ITEM_CATEGORY_TOOL,
+	ITEM_CATEGORY_MATERIAL,
+	ITEM_CATEGORY_TREASURE
+} ItemCategory;
+
+typedef struct {
+	const char* key; // Stable, what saves store
+	const char* name;
+	ItemCategory category;
+	int maxStack;
+	int value; // In gold
+} ItemDef;
+
+// What gameplay reads per item, 12 bytes
+typedef struct {
+	unsigned int sortKey; // Category, then name order: the inventory UI sorts on this alone
+	int value;
+	unsigned short maxStack;
+	unsigned char category;
+	unsigned char reserved;
+} ItemRecord;
+
+void InitItemDatabase(void);
+int GetItemCount(void); // Valid ids are 1..GetItemCount()
+
+ItemId FindItem(const char* key); // ITEM_NONE if unknown; for loading and authoring, not per frame
+ItemId FindItemByName(const char* name); // Linear, for migrating old saves only
+const ItemRecord* GetItemRecord(ItemId item); // NULL for ITEM_NONE or an unknown id
+const char* GetItemKey(ItemId item);
+const char* GetItemName(ItemId item);
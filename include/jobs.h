@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+
+#define JOB_MAX_WORKERS 15
+#define JOB_QUEUE_SIZE 1024 // Per thread, power of two
+#define JOB_POOL_SIZE 1024 // Jobs a thread can have in flight before its oldest slot is reused
+
+// Work-stealing job system. Every worker, and the thread that called InitJobSystem(),
+// owns a deque: it pushes and pops its own jobs at the bottom, idle workers steal from
+// the top of someone else's. Waiting on a counter runs jobs instead of blocking, so jobs
+// may submit and wait on more jobs, and so may Scene Update callbacks.
+//
+// Jobs run on any thread and must not call raylib: only the main thread owns the window
+// and the GL context. Other threads (asset worker, save writer) may submit too; their
+// jobs simply run inline.
+
+typedef void (*JobFunc)(void* data, int begin, int end);
+
+typedef struct Job Job;
+
+// Zero-initialize. Counts the jobs started with it that have not finished yet.
+typedef struct {
+	volatile long long pending;
+	volatile long long lock; // Guards waiters
+	Job* waiters; // Started once pending drops to zero
+} JobCounter;
+
+// workerCount 0 picks one per core beyond the calling thread. Without InitJobSystem(),
+// or with no workers, everything runs inline on the caller.
+void InitJobSystem(int workerCount);
+void ShutdownJobSystem(void); // Outstanding jobs must have been waited for
+int GetJobWorkerCount(void);
+
+// func(data, 0, 1) on some thread; counter may be NULL
+void RunJob(JobFunc func, void* data, JobCounter* counter);
+// Like RunJob, once dependency has no pending jobs left
+void RunJobAfter(JobFunc func, void* data, JobCounter* counter, JobCounter* dependency);
+void WaitForJobs(JobCounter* counter); // Runs other jobs while it waits
+bool AreJobsDone(const JobCounter* counter);
+
+// Calls func over [0, count) in ranges of about grain items, spread over every worker and
+// the caller. Returns once every range is done.
+void ParallelFor(JobFunc func, void* data, int count, int grain);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "raylib.h"
+
+// A layer that is drawn once into a render texture and then composited with a single
+// blit every frame. The owner passes a hash of everything the layer's content depends
+// on (textures, screen size, ...); the layer is redrawn only when that hash or the size
+// changes, or after an explicit InvalidateCachedLayer() or InvalidateAllCachedLayers().
+
+typedef struct {
+	RenderTexture2D target;
+	unsigned int inputsHash;
+	bool valid;
+	unsigned int epoch; // InvalidateAllCachedLayers() count when last drawn
+	int redraws;
+} CachedLayer;
+
+unsigned int HashLayerInputs(unsigned int hash, const void* data, int size);
+
+// Returns true if the layer needs redrawing. In that case drawing is redirected into the
+// layer until EndCachedLayer().
+bool BeginCachedLayer(CachedLayer* layer, int width, int height, unsigned int inputsHash);
+void EndCachedLayer(CachedLayer* layer);
+
+void DrawCachedLayer(const CachedLayer* layer, Vector2 position);
+Rectangle GetCachedLayerSource(const CachedLayer* layer); // Flipped source rect for DrawTexturePro/BatchSprite
+void InvalidateCachedLayer(CachedLayer* layer);
+void InvalidateAllCachedLayers(void); // After texture contents changed under the same ids
+void UnloadCachedLayer(CachedLayer* layer);
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "raylib.h"
+#include <stdarg.h>
+
+#define LOG_RING_SIZE 1024 // Records in flight; must be a power of two
+#define LOG_MESSAGE_MAX 256
+
+// Asynchronous logging. The calling thread formats the message text itself, since a
+// va_list cannot outlive the call, into a slot of a lock-free ring and returns. Only the
+// timestamp and the write to stdout happen on a background thread. When the ring is full the message is dropped and counted, never waited on.
+// Levels are raylib's TraceLogLevel values.
+
+typedef struct {
+	long long written;
+	long long dropped;
+} LoggerStats;
+
+void InitLogger(void);
+void ShutdownLogger(void); // Flushes everything still queued
+
+void DebugLog(int level, const char* format, ...); // Printed as "[DEBUG INFO] ...", "[DEBUG WARN] ..." etc.
+void LogRaylibMessage(int level, const char* text, va_list args); // For SetTraceLogCallback, printed with a timestamp
+
+LoggerStats GetLoggerStats(void);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Thin OS layer for the few things raylib does not wrap: threads, locks, read-only
+// file mappings and a monotonic clock that works before InitWindow. Kept free of raylib.h so that
+// platform.c can include <windows.h> without the usual name clashes.
+
+typedef struct PlatformThread PlatformThread;
+typedef struct PlatformMutex PlatformMutex;
+typedef struct PlatformCond PlatformCond;
+typedef struct PlatformMappedFile PlatformMappedFile;
+
+typedef int (*PlatformThreadFunc)(void* arg);
+
+PlatformThread* PlatformCreateThread(PlatformThreadFunc func, void* arg);
+void PlatformJoinThread(PlatformThread* thread);
+
+PlatformMutex* PlatformCreateMutex(void);
+void PlatformDestroyMutex(PlatformMutex* mutex);
+void PlatformLockMutex(PlatformMutex* mutex);
+void PlatformUnlockMutex(PlatformMutex* mutex);
+
+PlatformCond* PlatformCreateCond(void);
+void PlatformDestroyCond(PlatformCond* cond);
+void PlatformWaitCond(PlatformCond* cond, PlatformMutex* mutex);
+void PlatformSignalCond(PlatformCond* cond);
+void PlatformBroadcastCond(PlatformCond* cond);
+
+// Maps a whole file read-only. The pages are loaded on first touch and shared with the
+// OS file cache. NULL if the file is missing or empty.
+PlatformMappedFile* PlatformMapFile(const char* path, const void** data, size_t* size);
+void PlatformUnmapFile(PlatformMappedFile* file);
+
+// Watches a directory tree for files that were written or moved into it. NULL where
+// that is not supported (Windows uses ReadDirectoryChangesW, Linux inotify).
+typedef struct PlatformWatcher PlatformWatcher;
+PlatformWatcher* PlatformWatchDirectory(const char* path);
+// Blocks until a file changes and writes its path relative to the watched directory.
+// Returns false once PlatformCancelWatch() was called.
+bool PlatformWaitForFileChange(PlatformWatcher* watcher, char* path, int pathSize);
+void PlatformCancelWatch(PlatformWatcher* watcher); // Wakes the waiting thread
+void PlatformCloseWatcher(PlatformWatcher* watcher); // After the waiting thread is done
+
+double PlatformGetTime(void); // Monotonic seconds
+void PlatformSleep(double seconds);
+int PlatformGetCpuCount(void); // Logical cores, at least 1
+
+// CPU features the hot loops can dispatch on. Always false on non-x86 targets.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PLATFORM_X86 1
+#endif
+
+typedef struct {
+	bool sse2;
+	bool avx2; // Only set when the OS also saves the YMM registers
+} PlatformCpuFeatures;
+
+PlatformCpuFeatures PlatformGetCpuFeatures(void);
+
+// Relaxed 64-bit atomic add, for counters bumped from more than one thread
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PlatformAtomicAdd64(ptr, value) _InterlockedExchangeAdd64((volatile long long*)(ptr), (long long)(value))
+#else
+#define PlatformAtomicAdd64(ptr, value) __atomic_fetch_add((ptr), (long long)(value), __ATOMIC_RELAXED)
+#endif
+
+// Acquire load, release store and compare-and-swap, for the lock-free queues
+static inline long long PlatformAtomicLoad64(volatile long long* ptr)
+{
+#if defined(_MSC_VER)
+	return _InterlockedOr64(ptr, 0);
+#else
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void PlatformAtomicStore64(volatile long long* ptr, long long value)
+{
+#if defined(_MSC_VER)
+	_InterlockedExchange64(ptr, value);
+#else
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline bool PlatformAtomicCas64(volatile long long* ptr, long long expected, long long desired)
+{
+#if defined(_MSC_VER)
+	return _InterlockedCompareExchange64(ptr, desired, expected) == expected;
+#else
+	return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+
+// Full barrier, for the places where acquire/release ordering is not enough
+static inline void PlatformAtomicFence(void)
+{
+#if defined(_MSC_VER)
+	volatile long long barrier = 0;
+	_InterlockedOr64(&barrier, 0);
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
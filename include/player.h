@@ -0,0 +1,29 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+#include "animation.h"
+#include "ecs.h"
+
+#define PLAYER_WALK_SPEED 240.0f // Pixels per second
+#define PLAYER_RUN_SPEED 420.0f // Added on top of walking
+
+// The player's position and animation live in the entity world like any other entity;
+// this struct only holds what turns input into that state. Its clips come from an .anim
+// spec (animation.h); DrawVisibleEntities draws it.
+typedef struct {
+	EntityWorld* world;
+	EntityId entity;
+	const TextureAtlas* atlas;
+	const AnimationSet* animations;
+	bool isRunning;
+	Rectangle walkArea; // World rectangle the player is kept inside
+} Player;
+
+Player CreatePlayer(EntityWorld* world, const char* animationPath, Vector2 startPos);
+void UpdatePlayer(Player* player, float dt); // Input -> entity state; MoveEntities/AnimateEntities do the rest
+void FreePlayer(Player* player);
+
+Vector2 GetPlayerPosition(const Player* player);
+Vector2 GetPlayerSize(const Player* player); // Of the animation cell
+int GetPlayerFrame(const Player* player);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+
+#define PROFILER_RING_SIZE 4096 // Zones kept per thread; must be a power of two
+#define PROFILER_MAX_THREADS 20 // Main, logger, asset worker, save writer, file watcher and every job worker
+#define PROFILER_MAX_DEPTH 16
+#define PROFILER_MAX_ZONES 64 // Distinct (category, name) pairs shown by the overlay
+#define PROFILER_HISTORY 120 // Frames in the frame-time graph
+#define PROFILER_TRACE_FILE "celise_trace.json"
+
+// Frame profiler. Zones are timed on the thread that opens them and written to that
+// thread's own ring, so recording never takes a lock. Once per frame the main thread
+// folds the new zones into per-zone statistics for the overlay; a trace export writes
+// everything still in the rings as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Category and name must outlive the profiler, string literals and scene names do.
+//
+// Compiled out of release configs (NDEBUG); build with CELISE_PROFILE=0 or 1 to override.
+
+#if !defined(CELISE_PROFILE)
+#if defined(NDEBUG)
+#define CELISE_PROFILE 0
+#else
+#define CELISE_PROFILE 1
+#endif
+#endif
+
+#if CELISE_PROFILE
+
+void ProfileBegin(const char* category, const char* name);
+void ProfileEnd(void);
+void ProfileEndAs(const char* name); // For zones whose name is only known once they end
+void ProfileThreadName(const char* name); // Label for the calling thread in traces
+void ProfileFrame(void); // Call once per frame, after EndDrawing()
+
+void DrawProfilerOverlay(void);
+bool ExportProfilerTrace(const char* path);
+
+#define PROFILE_BEGIN(category, name) ProfileBegin(category, name)
+#define PROFILE_END() ProfileEnd()
+#define PROFILE_END_AS(name) ProfileEndAs(name)
+#define PROFILE_THREAD_NAME(name) ProfileThreadName(name)
+#define PROFILE_FRAME() ProfileFrame()
+
+// Times the statement or block that follows. Leaving it with break, return or goto skips the end.
+#define PROFILE_ZONE(category, name) for (int profileZoneOnce = (ProfileBegin(category, name), 1); profileZoneOnce; ProfileEnd(), profileZoneOnce = 0)
+
+#else
+
+#define PROFILE_BEGIN(category, name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_END_AS(name) ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_ZONE(category, name)
+
+static inline void DrawProfilerOverlay(void) {}
+static inline bool ExportProfilerTrace(const char* path) { (void)path; return false; }
+
+#endif
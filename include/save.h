@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SAVE_QUICKSAVE_FILE "quicksave.csav"
+#define SAVE_MAGIC 0x56415343u // "CSAV"
+#define SAVE_VERSION 1
+#define SAVE_ALIGNMENT 16
+#define SAVE_MAX_SECTION_SIZE 4096
+#define SAVE_MAX_PATH 256
+#define SAVE_COMPACT_RATIO 4 // The file is rewritten once it is this many times its live size
+#define SAVE_EMPTY_SLOT 0xFFFFFFFFu
+
+// Save files are append-only. A save serializes every section on the calling thread
+// (microseconds), then a background writer compares each section's hash with the one in
+// the file and appends only the changed sections, followed by a new footer that lists
+// where every section lives. The last valid footer is the save. Footers sit on
+// SAVE_ALIGNMENT boundaries, so after a write that was cut short the loader steps back
+// to the previous one.
+//
+// Sections are flat and relocatable: nothing in them is a pointer, references are byte
+// offsets from the start of the section. Loading maps the file, validates the footer and
+// every section hash, then copies what it needs and turns the offsets back into pointers.
+//
+// Layout (little-endian): sections and footers, each starting on a SAVE_ALIGNMENT
+// boundary. Normally the last bytes of the file are the current SaveFooter.
+
+typedef enum {
+	SAVE_SECTION_PLAYER,    // SavePlayerSection
+	SAVE_SECTION_CHARACTER, // SaveCharacterSection, then the name
+	SAVE_SECTION_INVENTORY, // SaveInventorySection, then item keys and used slots
+	SAVE_SECTION_HUD,       // SaveHudSection
+	SAVE_SECTION_COUNT
+} SaveSectionId;
+
+typedef struct {
+	uint32_t offset; // From the start of the file, 0 when the section is missing
+	uint32_t size;
+	uint32_t version; // Of this section's layout
+	uint32_t hash; // FNV-1a of the section bytes
+} SaveSectionEntry;
+
+typedef struct {
+	SaveSectionEntry sections[SAVE_SECTION_COUNT];
+	uint32_t generation; // Saves made to this file
+	uint32_t liveSize; // Bytes of the sections listed above
+	uint32_t version;
+	uint32_t hash; // Of everything above
+	uint32_t reserved[3];
+	uint32_t magic; // Last, so a footer that was only partly written does not validate
+} SaveFooter;
+
+typedef struct {
+	float x;
+	float y;
+	float direction;
+	int32_t sceneId; // Loading is refused from any other scene
+} SavePlayerSection;
+
+typedef struct {
+	int32_t height;
+	int32_t weight;
+	int32_t strength;
+	int32_t charisma;
+	int32_t wisdom;
+	int32_t intelligence;
+	int32_t dexterity;
+	int32_t vitality;
+	uint32_t nameOffset; // NUL terminated
+	uint32_t reserved;
+} SaveCharacterSection;
+
+// Items are stored by key, so saves survive ids changing as the item table grows
+typedef struct {
+	int32_t capacity;
+	uint32_t keyCount; // Distinct items
+	uint32_t keysOffset; // keyCount uint32_t offsets of NUL terminated item keys
+	uint32_t slotCount; // Used slots
+	uint32_t slotsOffset; // slotCount SaveInventorySlot
+	uint32_t reserved;
+} SaveInventorySection;
+
+typedef struct {
+	uint16_t slot;
+	uint16_t count;
+	uint32_t keyIndex;
+} SaveInventorySlot;
+
+// Version 1, one item name per slot, still loaded
+typedef struct {
+	int32_t maxItemCount;
+	uint32_t nameCount; // Distinct item names
+	uint32_t slotsOffset; // maxItemCount uint32_t indices into the names, SAVE_EMPTY_SLOT when empty
+	uint32_t namesOffset; // nameCount uint32_t offsets of NUL terminated names
+} SaveInventorySectionV1;
+
+typedef struct {
+	int32_t gold;
+	float hpPercentage;
+	int64_t minutes; // GetGameMinutes()
+} SaveHudSection;
+
+typedef struct {
+	long long saves;
+	long long sectionsWritten;
+	long long sectionsSkipped; // Unchanged since the last save to the same file
+	long long bytesWritten;
+	long long compactions;
+	double lastSerializeMs; // On the calling thread
+	double lastWriteMs; // On the writer thread
+	double lastLoadMs;
+} SaveStats;
+
+void InitSaveSystem(void); // Starts the writer thread
+void ShutdownSaveSystem(void); // Finishes the save in flight, if any
+
+// Snapshots the game state and queues it for writing; returns right away. A save queued
+// while another is being written replaces any save still waiting.
+bool QuickSave(const char* path);
+// Applies the save at path to the running game, after any queued save is written
+bool LoadSave(const char* path);
+void WaitForSaveWriter(void);
+
+SaveStats GetSaveStats(void);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "raylib.h"
+#include "asset_cache.h"
+#include "profiler.h"
+
+#define MAX_SCENES 10
+
+typedef enum {
+	SCENE_BASE,
+	SCENE_TITLE_SCREEN,
+	SCENE_MAIN_MENU,
+	SCENE_CASTLE_PROLOGUE,
+	SCENE_TOP_BAR,
+	SCENE_ID_COUNT
+} SceneId;
+
+// How a scene composes with the ones below it in the stack
+#define SCENE_BLOCKS_UPDATE (1u << 0) // Scenes below stop ticking
+#define SCENE_BLOCKS_RENDER (1u << 1) // Covers the whole screen, scenes below are not drawn
+#define SCENE_OVERLAY (1u << 2)       // Drawn over the scene below without taking focus (HUD, dialogs)
+#define SCENE_PERSISTENT (1u << 3)    // Cannot be popped
+
+typedef struct {
+	SceneId id;
+	unsigned int flags;
+	char* scene_name; // For logs only
+	const AssetManifest* successorAssets; // Prefetched in the background once this scene is pushed
+
+	void (*Update) (void* ctx);
+	void (*Render) (void* ctx);
+	void (*Free) (void* ctx);
+	void* ctx;
+} Scene;
+
+// Which layers tick and draw only changes on push/pop, so it is worked out there:
+// every frame updates scenes[updateFrom..top] and renders scenes[renderFrom..top].
+typedef struct {
+	Scene* scenes[MAX_SCENES];
+	int scene_count;
+	int top;
+	int updateFrom;
+	int renderFrom;
+	int focus; // Topmost scene that is not an overlay
+	unsigned int version; // Bumped on every push/pop
+} SceneStack;
+
+extern SceneStack* globalSceneStack;
+
+SceneStack* InitSceneStack();
+void PushScene(SceneStack* stack, Scene* scene);
+void PopScene(SceneStack* stack);
+Scene* GetCurrentScene(SceneStack* stack); // Topmost scene, overlays included
+Scene* GetFocusScene(SceneStack* stack);
+
+// Scene callbacks are always invoked through these, each one is a profiler zone named after the scene
+void UpdateScene(Scene* scene);
+void RenderScene(Scene* scene);
+void FreeScene(Scene* scene);
+void LogSceneResidency(const SceneStack* stack); // Texture memory per scene in the stack, and overall
+
+// Wraps a Create*Scene() call in a "load" zone: PushScene(stack, LoadScene(CreateMainMenuScene(...)))
+// The assets it acquires are attributed to the scene id for the residency log.
+#define LoadScene(create) (PROFILE_BEGIN("load", "scene"), BeginAssetScope(), EndSceneLoad(create))
+Scene* EndSceneLoad(Scene* scene);
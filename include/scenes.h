@@ -0,0 +1,102 @@
+#pragma once
+
+#include "raylib.h"
+#include "scene.h"
+#include "layer_cache.h"
+#include "arena.h"
+#include "tilemap.h"
+#include "text.h"
+#include "screen_texture.h"
+#include "world_camera.h"
+#include "entity.h"
+
+typedef struct {
+	int dummy;
+} BaseSceneContext;
+
+typedef struct {
+	int frameCount;
+	Texture2D** backgroundTextures;
+	Texture2D** foregroundTextures;
+	const char** strings;
+	Font** fonts;
+	bool isSceneRendered;
+} SceneContext;
+
+typedef struct {
+	int wFrameCount;
+	Texture2D logo;
+	ScreenTexture bg;
+	const char* message;
+	TextFont scene_font; // Baked at 32 px
+} TitleScreenContext;
+
+typedef struct {
+	int wFrameCount;
+	bool logoSettled;
+	bool buttonSelected;
+	float prevLogoY;
+	float logoY;
+	float targetLogoY;
+	Texture2D logo;
+	ScreenTexture bg;
+	Texture2D newGameButton;
+	Texture2D newGameButtonHover;
+
+} MainMenuContext;
+
+typedef struct
+{
+	int wFrameCount;
+	bool sceneRendered;
+	Tilemap* level; // Wall, floor and carpet
+	WorldCamera camera;
+	EntityId interactables[4]; // Invisible trigger entities along the hall
+	int interactableCount;
+	EntityId interactTarget; // Nearest interactable in reach, NULL_ENTITY if none
+	Texture2D interactIcon;
+} CeliseCastleContext;
+
+typedef struct {
+	int wFrameCount;
+	const TextureAtlas* atlas; // The HUD pieces below are regions of the shared sprite atlas
+	Rectangle bg;
+	Rectangle portrait_frame;
+	Rectangle portrait;
+	Rectangle ui_frame;
+	CachedLayer frameLayer; // Everything above, drawn once
+	Arena* arena; // Lives as long as the bar; freed in UnloadTopBar
+	TextFont nameFont; // Baked at 24 px
+	TextFont hudFont; // Baked at 20 px
+	char* character_name; // In arena
+	Texture2D hp_bar;
+	Texture2D hp_fill;
+	float hp_percentage;
+	Texture2D interact_icon;
+	Texture2D inventory_icon;
+	Texture2D journal_icon;
+	Texture2D daylight_icon;
+	Texture2D map_icon;
+	Texture2D menu_icon;
+	Texture2D gold_icon;
+	char* datetime; // In the frame arena, rebuilt every frame
+	int gold;
+
+} TopBarContext;
+
+extern TitleScreenContext title_screen_context;
+extern Scene title_scene;
+extern BaseSceneContext base_scene_context;
+extern Scene base_scene;
+extern MainMenuContext main_menu_context;
+extern Scene main_menu_scene;
+extern CeliseCastleContext celise_castle_context;
+extern Scene prologue_scene;
+extern TopBarContext top_bar_context;
+extern Scene top_bar_scene;
+
+Scene* CreateTitleScreenScene(TitleScreenContext* context, Scene* scene);
+Scene* CreateBaseScene(BaseSceneContext* context, Scene* scene);
+Scene* CreateMainMenuScene(MainMenuContext* context, Scene* scene);
+Scene* CreateCastleScene(CeliseCastleContext* context, Scene* scene);
+Scene* CreateTopBar(TopBarContext* context, Scene* scene);
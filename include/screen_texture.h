@@ -0,0 +1,23 @@
+#pragma once
+
+#include "raylib.h"
+
+// A full-screen image (backgrounds) kept at the framebuffer resolution, so drawing it over
+// the window samples it 1:1 instead of stretching the source every frame. The variant for
+// the current size is scaled on the asset worker. Until it is ready, at load and again
+// after a resize, the texture at hand is drawn stretched.
+
+typedef struct {
+	const char* path;
+	Texture2D texture;
+	int width; // Framebuffer size texture was scaled for, 0 for the source image
+	int height;
+	int pendingWidth; // Variant on its way, 0 for none
+	int pendingHeight;
+} ScreenTexture;
+
+void AcquireScreenTexture(ScreenTexture* screen, const char* path);
+void UpdateScreenTexture(ScreenTexture* screen); // Once a frame before drawing; swaps in new variants
+// Queued at SPRITE_LAYER_BACKGROUND; an opaque image then lets ClearFrame() skip the color clear
+void BatchScreenTexture(const ScreenTexture* screen, Color tint);
+void ReleaseScreenTexture(ScreenTexture* screen);
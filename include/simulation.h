@@ -0,0 +1,18 @@
+#pragma once
+
+#define SIM_TICK_RATE 60       // Default simulation ticks per second
+#define SIM_MAX_FRAME_TIME 0.25 // Longest frame we try to catch up on (load stalls, breakpoints)
+
+// Fixed-timestep clock. Each rendered frame asks how many simulation ticks are due,
+// runs exactly that many updates at GetSimulationDelta(), then renders with
+// GetRenderAlpha() to interpolate between the last two simulated states.
+
+void InitSimulationClock(int ticksPerSecond);
+void SetSimulationRate(int ticksPerSecond);
+int AdvanceSimulationClock(void);
+void StepSimulationClock(void); // Exactly one tick, without reading the wall clock (headless runs)
+
+float GetSimulationDelta(void);
+float GetRenderAlpha(void);
+long long GetSimulationTick(void);
+double GetSimulationTime(void); // Simulated seconds since InitSimulationClock(), at whatever rates ran
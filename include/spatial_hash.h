@@ -0,0 +1,33 @@
+#pragma once
+
+#include "raylib.h"
+#include "ecs.h"
+
+#define SPATIAL_CELL_SIZE 128.0f
+#define SPATIAL_BUCKETS 1024 // Must be a power of two
+
+// Uniform grid over entity positions, hashed into a fixed bucket table so the world
+// needs no bounds. Rebuilt once per tick after MoveEntities; queries then only visit
+// the cells around the area asked about. Results are dense indices into the world and
+// stay valid until the next spawn/despawn.
+
+typedef struct SpatialHash {
+	float cellSize;
+	int capacity;
+	int count; // Entities indexed by the last rebuild
+	float maxExtent; // Largest entity width/height; rect queries reach back this far
+	int heads[SPATIAL_BUCKETS]; // First entity in each bucket, -1 when empty
+	int* next; // Next entity in the same bucket
+	int* cellX; // Cell each entity was filed under
+	int* cellY;
+} SpatialHash;
+
+SpatialHash* CreateSpatialHash(int capacity, float cellSize);
+void DestroySpatialHash(SpatialHash* hash);
+void RebuildSpatialHash(SpatialHash* hash, const EntityWorld* world);
+
+// Entities whose bounds (position + frame size) overlap rect. Returns the number found,
+// writes at most maxResults of them.
+int QueryEntitiesInRect(const SpatialHash* hash, const EntityWorld* world, Rectangle rect, int* results, int maxResults);
+// Entities whose centre lies within radius of center
+int QueryEntitiesInRadius(const SpatialHash* hash, const EntityWorld* world, Vector2 center, float radius, int* results, int maxResults);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "raylib.h"
+#include "text.h"
+
+#define MAX_BATCH_SPRITES 4096
+
+// Draw order inside a batch; lower layers are drawn first
+#define SPRITE_LAYER_BACKGROUND -10
+#define SPRITE_LAYER_WORLD 0
+#define SPRITE_LAYER_CHARACTERS 10
+#define SPRITE_LAYER_HUD 20
+
+// Batched sprites sit between this depth and 0, nearer is larger (raylib's screen
+// projection keeps z in [-1, 0]); tile layers (tilemap.h) are drawn behind them
+#define SPRITE_DEPTH_FAR -0.5f
+#define OVERDRAW_TINT (Color){ 32, 16, 8, 255 } // Added once per write in the overdraw views
+
+// Deferred sprite drawing. Sprites queued between BeginSpriteBatch() and EndSpriteBatch()
+// are sorted by layer, then texture. raylib flushes its own vertex batch on every texture
+// change, so sprites that share an atlas end up in one draw call.
+//
+// Sprites with full alpha in their tint and in what they sample, a whole texture
+// (IsTextureOpaque()) or one atlas region (IsAtlasSourceOpaque()), are opaque: they are
+// drawn first, front to back with depth writes and blending off, so whatever they cover is
+// rejected by the depth test instead of shaded. The rest, text and cached layers included,
+// are blended back to front over them, depth tested but not written.
+
+typedef struct {
+	int sprites;
+	int opaqueSprites;
+	int drawCalls;
+} SpriteBatchStats;
+
+// Debug views, cycled with F4. The overdraw views draw every sprite and tile as a flat
+// additive OVERDRAW_TINT, so a pixel's brightness counts how often it was written; the
+// second one blends everything back to front, as without the opaque pass, to compare.
+typedef enum {
+	DRAW_VIEW_NORMAL,
+	DRAW_VIEW_OVERDRAW,
+	DRAW_VIEW_OVERDRAW_BLENDED,
+	DRAW_VIEW_COUNT
+} DrawView;
+
+void BeginSpriteBatch(void);
+void BatchSprite(Texture2D texture, Rectangle source, Rectangle dest, int layer, Color tint);
+void BatchSpriteTiled(Texture2D texture, Rectangle source, Rectangle dest, int layer, Color tint);
+// Text is drawn with the font's glyph texture, so it sorts like any other sprite. It goes
+// through the layout cache (text.h); the string itself is not kept.
+void BatchText(const TextFont* font, const char* text, Vector2 position, float fontSize, float spacing, int layer, Color tint);
+void BatchTextLayout(const TextLayout* layout, Vector2 position, int layer, Color tint);
+void EndSpriteBatch(void);
+
+// Clears the frame before a scene draws into it. Only depth is cleared once an opaque sprite
+// queued in this batch covers the screen, since its pixels would all be overwritten: queue
+// the background first.
+void ClearFrame(Color color);
+// DrawTexturePro() without rotation, at an explicit depth; honours the draw view
+void DrawSpriteQuad(Texture2D texture, Rectangle source, Rectangle dest, Color tint, float depth);
+
+SpriteBatchStats GetSpriteBatchStats(void); // Counts for the last completed batch
+void SetDrawView(DrawView view);
+DrawView GetDrawView(void);
+const char* GetDrawViewName(DrawView view);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "raylib.h"
+
+#define TEXT_LAYOUT_SETS 16 // Power of two
+#define TEXT_LAYOUT_WAYS 4
+#define TEXT_LAYOUT_MAX_BYTES 64 // Longer strings are laid out into the frame arena every time
+#define TEXT_LINE_SPACING 2 // raylib's default
+
+// Text for scenes and the HUD. Fonts are glyph atlases baked by the asset cache (or the
+// bundle), either at the exact pixel size they are drawn at or as one distance field that
+// scales to any size. Laying a string out (UTF-8 decoding, glyph lookup, placing quads)
+// happens once and is cached by (font, size, spacing, string), so text that does not
+// change costs a lookup and its quads. A layout stays valid until the frame arena resets.
+
+typedef struct {
+	Font font;
+	bool sdf;
+} TextFont;
+
+typedef struct {
+	Rectangle source; // In the font atlas
+	Rectangle dest; // Relative to the text position
+} GlyphQuad;
+
+typedef struct {
+	Texture2D texture;
+	bool sdf;
+	Vector2 size; // Same as MeasureTextEx
+	int quadCount;
+	const GlyphQuad* quads;
+} TextLayout;
+
+typedef struct {
+	long long hits;
+	long long misses;
+	long long evictions;
+	long long uncached; // Too long, or every way of the set already used this frame
+} TextCacheStats;
+
+// size is the pixel size the text is drawn at; ignored for distance field fonts
+TextFont AcquireTextFont(const char* path, int size, bool sdf);
+void ReleaseTextFont(TextFont font);
+
+// NULL for NULL text, or when an uncached layout does not fit in the frame arena
+const TextLayout* LayoutText(const TextFont* font, const char* text, float size, float spacing);
+void DrawTextLayout(const TextLayout* layout, Vector2 position, Color tint, float depth); // See SPRITE_DEPTH_FAR
+void InvalidateTextLayouts(void); // After a font was rebaked in place
+void ShutdownText(void); // Unloads the distance field shader; call before CloseWindow()
+
+TextCacheStats GetTextCacheStats(void);
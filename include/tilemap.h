@@ -0,0 +1,72 @@
+#pragma once
+
+#include "raylib.h"
+#include "atlas.h"
+
+#define TILE_CHUNK_SIZE 16 // Tiles per chunk side
+#define MAX_TILEMAP_LAYERS 4
+#define MAX_TILE_TYPES ATLAS_MAX_REGIONS
+
+// Grid levels. Each layer stores one byte per tile and is split into
+// TILE_CHUNK_SIZE x TILE_CHUNK_SIZE chunks; every chunk is turned into a single mesh
+// of quads once, and drawing a layer submits only the chunks that touch the view.
+// Tile types are the images of one atlas: type n is desc->paths[n - 1], 0 is empty.
+
+typedef unsigned char TileIndex;
+
+typedef struct {
+	Mesh mesh; // World-space quads of every non-empty tile in the chunk
+	Rectangle bounds;
+	int quadCount;
+	bool opaque; // Only tiles whose images have full alpha
+	bool dirty;
+	bool uploaded;
+} TileChunk;
+
+typedef struct {
+	Vector2 origin; // World position of the top-left corner of tile (0, 0)
+	float tileWidth;
+	float tileHeight;
+	int width; // In tiles
+	int height;
+	TileIndex* tiles; // Row-major, width * height
+	int chunksX;
+	int chunksY;
+	TileChunk* chunks;
+	int dirtyChunks; // Lets BuildTilemap skip untouched layers without scanning them
+} TileLayer;
+
+typedef struct {
+	const TextureAtlas* atlas;
+	Rectangle tileSources[MAX_TILE_TYPES + 1];
+	bool tileOpaque[MAX_TILE_TYPES + 1];
+	int tileTypeCount;
+	int layerCount;
+	TileLayer layers[MAX_TILEMAP_LAYERS];
+	Material material;
+	bool materialLoaded;
+} Tilemap;
+
+typedef struct {
+	int chunksDrawn;
+	int chunksCulled;
+	int quads;
+} TilemapDrawStats;
+
+Tilemap* CreateTilemap(const AtlasDesc* tiles);
+void FreeTilemap(Tilemap* map);
+
+TileLayer* AddTileLayer(Tilemap* map, Vector2 origin, float tileWidth, float tileHeight, int width, int height);
+void SetTile(TileLayer* layer, int x, int y, TileIndex tile);
+void FillTiles(TileLayer* layer, int x, int y, int width, int height, TileIndex tile);
+Rectangle GetTileLayerBounds(const TileLayer* layer);
+Rectangle GetTilemapBounds(const Tilemap* map); // Union of all layers
+Vector2 GetTileSize(const Tilemap* map, TileIndex tile); // Size of the tile's image
+
+// Rebuilds the vertex data of chunks whose tiles changed. DrawTilemap calls it, but
+// levels can call it right after loading so the first frame does not pay for it.
+void BuildTilemap(Tilemap* map);
+// Layers stack back to front behind the sprite batch (SPRITE_DEPTH_FAR). Opaque chunks are
+// drawn first, front to back with depth writes, so a layer only shades what shows through
+// the ones above it; the rest are blended back to front after them.
+TilemapDrawStats DrawTilemap(Tilemap* map, Rectangle view);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "raylib.h"
+
+// Camera for scenes that are larger than the screen. It eases towards a focus point
+// each tick and never shows anything outside its bounds. Like entities, it keeps the
+// previous tick's target so rendering can interpolate between ticks.
+
+typedef struct {
+	Camera2D camera;
+	Vector2 prevTarget;
+	Rectangle bounds;
+} WorldCamera;
+
+void InitWorldCamera(WorldCamera* camera, Rectangle bounds, Vector2 focus);
+void UpdateWorldCamera(WorldCamera* camera, Vector2 focus, float dt);
+Camera2D GetRenderCamera(const WorldCamera* camera, float alpha);
+
+Rectangle GetCameraView(Camera2D camera); // The world rectangle on screen
+Rectangle WorldToScreenRect(Camera2D camera, Rectangle rect);
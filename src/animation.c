@@ -0,0 +1,176 @@
+#include "animation.h"
+#include "bundle.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+	char path[ANIMATION_MAX_PATH];
+	int refCount;
+	AnimationSet set;
+} AnimationSlot;
+
+static AnimationSlot slots[ANIMATION_MAX_SETS];
+
+// ------ Loading ------
+
+static bool LoadBakedSet(const char* path, const void* data, uint64_t size, const TextureAtlas* atlas, AnimationSet* set)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	const ClipSetHeader* header = (const ClipSetHeader*)bytes;
+	if (size < sizeof(ClipSetHeader) || header->sheetCount > ANIMATION_MAX_SHEETS || header->frameCount > ANIMATION_MAX_FRAMES ||
+		size < sizeof(ClipSetHeader) + (uint64_t)header->sheetCount * ANIMATION_MAX_PATH +
+			(uint64_t)header->clipCount * sizeof(ClipRecord) + (uint64_t)header->frameCount * sizeof(ClipFrameRecord))
+	{
+		DebugLog(LOG_ERROR, "Baked animation <%s> has a bad payload size", path);
+		return false;
+	}
+
+	const char* sheets = (const char*)(bytes + sizeof(ClipSetHeader));
+	const ClipRecord* clips = (const ClipRecord*)(sheets + header->sheetCount * ANIMATION_MAX_PATH);
+	const ClipFrameRecord* frames = (const ClipFrameRecord*)(clips + header->clipCount);
+
+	Rectangle regions[ANIMATION_MAX_SHEETS];
+	for (int s = 0; s < header->sheetCount; s++)
+	{
+		regions[s] = GetAtlasRegion(atlas, sheets + s * ANIMATION_MAX_PATH);
+	}
+
+	set->cellSize = (Vector2){ header->cellWidth, header->cellHeight };
+	set->frameCount = header->frameCount;
+	for (int c = 0; c < header->clipCount; c++)
+	{
+		const ClipRecord* clip = &clips[c];
+		if (clip->state >= ENTITY_STATE_COUNT || clip->sheet >= header->sheetCount || clip->firstFrame + clip->frameCount > header->frameCount)
+		{
+			DebugLog(LOG_ERROR, "Baked animation <%s> has a bad clip", path);
+			return false;
+		}
+		set->clips[clip->state] = (AnimationClip){ clip->firstFrame, clip->frameCount, clip->loop != 0 };
+
+		// Baked rectangles are relative to the sheet, which the atlas may put anywhere
+		Rectangle region = regions[clip->sheet];
+		for (int f = clip->firstFrame; f < clip->firstFrame + clip->frameCount; f++)
+		{
+			set->frames[f] = (AnimationFrame){
+				{ region.x + frames[f].x, region.y + frames[f].y, frames[f].width, frames[f].height },
+				{ frames[f].offsetX, frames[f].offsetY },
+				frames[f].durationMs / 1000.0f
+			};
+		}
+	}
+	set->trimmed = true;
+	return true;
+}
+
+static bool LoadSpecSet(const char* path, const TextureAtlas* atlas, AnimationSet* set)
+{
+	char* text = LoadFileText(path);
+	if (!text)
+	{
+		DebugLog(LOG_ERROR, "Animation <%s> not found", path);
+		return false;
+	}
+
+	AnimationSpec spec;
+	char error[128] = { 0 };
+	bool parsed = ParseAnimationSpec(text, &spec, error, sizeof(error));
+	UnloadFileText(text);
+	if (!parsed)
+	{
+		DebugLog(LOG_ERROR, "Animation <%s>: %s", path, error);
+		return false;
+	}
+
+	set->cellSize = (Vector2){ (float)spec.cellWidth, (float)spec.cellHeight };
+	for (int c = 0; c < spec.clipCount; c++)
+	{
+		const AnimationSpecClip* clip = &spec.clips[c];
+		Rectangle region = GetAtlasRegion(atlas, clip->sheet);
+		if ((clip->firstCell + clip->cellCount) * spec.cellWidth > region.width || spec.cellHeight > region.height)
+		{
+			DebugLog(LOG_WARNING, "Animation <%s>: %s clip runs off <%s>", path, entityStateNames[clip->state], clip->sheet);
+		}
+
+		set->clips[clip->state] = (AnimationClip){ (unsigned short)set->frameCount, (unsigned short)clip->cellCount, clip->loop };
+		for (int f = 0; f < clip->cellCount; f++)
+		{
+			set->frames[set->frameCount++] = (AnimationFrame){
+				{ region.x + (float)((clip->firstCell + f) * spec.cellWidth), region.y, (float)spec.cellWidth, (float)spec.cellHeight },
+				{ 0.0f, 0.0f },
+				clip->durationMs / 1000.0f
+			};
+		}
+	}
+	set->trimmed = false;
+	DebugLog(LOG_INFO, "Animation <%s> loaded untrimmed; run CeliseBundle to bake it", path);
+	return true;
+}
+
+// ------ API ------
+
+const AnimationSet* AcquireAnimationSet(const char* path, const TextureAtlas* atlas)
+{
+	AnimationSlot* slot = NULL;
+	for (int i = 0; i < ANIMATION_MAX_SETS; i++)
+	{
+		if (slots[i].refCount > 0 && strcmp(slots[i].path, path) == 0)
+		{
+			slots[i].refCount++;
+			return &slots[i].set;
+		}
+		if (!slot && slots[i].refCount == 0) slot = &slots[i];
+	}
+	if (!slot || !atlas || strlen(path) >= ANIMATION_MAX_PATH)
+	{
+		DebugLog(LOG_ERROR, "Cannot load animation <%s>", path);
+		return NULL;
+	}
+
+	AnimationSet* set = &slot->set;
+	*set = (AnimationSet){ 0 };
+	uint64_t size = 0;
+	const void* baked = GetBundleClips(path, &size);
+	bool loaded = baked ? LoadBakedSet(path, baked, size, atlas, set) : LoadSpecSet(path, atlas, set);
+	if (!loaded) return NULL;
+
+	// States without a clip borrow idle's, or the first clip there is
+	const AnimationClip* fallback = &set->clips[IDLE];
+	for (int s = 0; s < ENTITY_STATE_COUNT && fallback->frameCount == 0; s++) fallback = &set->clips[s];
+	for (int s = 0; s < ENTITY_STATE_COUNT; s++)
+	{
+		if (set->clips[s].frameCount == 0) set->clips[s] = *fallback;
+	}
+
+	set->texture = atlas->texture;
+	snprintf(slot->path, sizeof(slot->path), "%s", path);
+	slot->refCount = 1;
+	return set;
+}
+
+void ReleaseAnimationSet(const AnimationSet* set)
+{
+	for (int i = 0; i < ANIMATION_MAX_SETS && set; i++)
+	{
+		if (&slots[i].set == set && slots[i].refCount > 0)
+		{
+			slots[i].refCount--;
+			return;
+		}
+	}
+}
+
+void SetEntityAnimation(EntityWorld* world, EntityId entity, const AnimationSet* set)
+{
+	int i = GetEntityIndex(world, entity);
+	if (i < 0) return;
+
+	world->animatedCount += (set != NULL) - (world->animations[i].set != NULL);
+	// An out-of-range clipState makes the next AnimateEntities() start the state's clip
+	world->animations[i] = (AnimationState){ set, 0.0f, 0, ENTITY_STATE_COUNT };
+	if (!set) return;
+
+	world->frameWidth[i] = set->cellSize.x;
+	world->frameHeight[i] = set->cellSize.y;
+	world->textures[i] = set->texture;
+}
@@ -0,0 +1,78 @@
+#include "animation.h"
+#include <stdio.h>
+#include <string.h>
+
+// Only raylib and the C library from here: CeliseBundle compiles this file too
+
+const char* const entityStateNames[ENTITY_STATE_COUNT] = {
+	"idle", "walking", "running", "jumping", "talking", "crouching", "attacking"
+};
+
+bool ParseAnimationSpec(const char* text, AnimationSpec* spec, char* error, int errorSize)
+{
+	memset(spec, 0, sizeof(*spec));
+	int frames = 0;
+	int lineNumber = 0;
+	while (text && *text)
+	{
+		char line[256];
+		int length = (int)strcspn(text, "\n");
+		snprintf(line, sizeof(line), "%.*s", length < (int)sizeof(line) - 1 ? length : (int)sizeof(line) - 1, text);
+		text += length + (text[length] == '\n');
+		lineNumber++;
+		char* comment = strchr(line, '#');
+		if (comment) *comment = '\0';
+
+		char keyword[16] = { 0 };
+		if (sscanf(line, "%15s", keyword) != 1) continue;
+		if (strcmp(keyword, "cell") == 0)
+		{
+			if (sscanf(line, "%*s %d %d", &spec->cellWidth, &spec->cellHeight) != 2 || spec->cellWidth <= 0 || spec->cellHeight <= 0)
+			{
+				snprintf(error, errorSize, "line %d: expected cell <width> <height>", lineNumber);
+				return false;
+			}
+			continue;
+		}
+		if (strcmp(keyword, "clip") != 0)
+		{
+			snprintf(error, errorSize, "line %d: unknown keyword <%s>", lineNumber, keyword);
+			return false;
+		}
+
+		char state[16] = { 0 };
+		char once[16] = { 0 };
+		AnimationSpecClip clip = { 0 };
+		int fields = sscanf(line, "%*s %15s %63s %d %d %d %15s", state, clip.sheet, &clip.firstCell, &clip.cellCount, &clip.durationMs, once);
+		if (fields < 5 || clip.firstCell < 0 || clip.cellCount <= 0 || clip.durationMs < 0 || (fields == 6 && strcmp(once, "once") != 0))
+		{
+			snprintf(error, errorSize, "line %d: expected clip <state> <sheet> <first cell> <cells> <ms> [once]", lineNumber);
+			return false;
+		}
+		int s = 0;
+		while (s < ENTITY_STATE_COUNT && strcmp(entityStateNames[s], state) != 0) s++;
+		bool duplicate = false;
+		for (int c = 0; c < spec->clipCount; c++) duplicate |= spec->clips[c].state == (EntityState)s;
+		if (s == ENTITY_STATE_COUNT || duplicate)
+		{
+			snprintf(error, errorSize, "line %d: %s state <%s>", lineNumber, duplicate ? "second clip for" : "unknown", state);
+			return false;
+		}
+		frames += clip.cellCount;
+		if (frames > ANIMATION_MAX_FRAMES)
+		{
+			snprintf(error, errorSize, "line %d: more than %d frames", lineNumber, ANIMATION_MAX_FRAMES);
+			return false;
+		}
+		clip.state = (EntityState)s;
+		clip.loop = fields < 6;
+		spec->clips[spec->clipCount++] = clip;
+	}
+
+	if (spec->cellWidth == 0 || spec->clipCount == 0)
+	{
+		snprintf(error, errorSize, "needs a cell line and at least one clip");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,108 @@
+#include "arena.h"
+#include "game_alloc.h"
+#include "logger.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT 16
+
+static Arena* frameArena = NULL;
+
+Arena* CreateArena(const char* name, size_t capacity)
+{
+	// Header and storage share one allocation
+	Arena* arena = (Arena*)GameAlloc(sizeof(Arena) + ARENA_ALIGNMENT + capacity);
+	if (!arena)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate %zu bytes for arena <%s>", capacity, name);
+		return NULL;
+	}
+	memset(arena, 0, sizeof(Arena));
+	arena->name = name;
+	arena->base = (unsigned char*)(((size_t)(arena + 1) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1));
+	arena->capacity = capacity;
+	return arena;
+}
+
+void DestroyArena(Arena* arena)
+{
+	if (!arena) return;
+	LogArenaStats(arena);
+	GameFree(arena);
+}
+
+void* ArenaAlloc(Arena* arena, size_t size)
+{
+	size_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	if (offset + size > arena->capacity)
+	{
+		if (arena->overflows++ == 0)
+		{
+			DebugLog(LOG_WARNING, "Arena <%s> out of space (%zu of %zu bytes used, %zu requested)", arena->name, arena->used, arena->capacity, size);
+		}
+		return NULL;
+	}
+	arena->used = offset + size;
+	if (arena->used > arena->highWater) arena->highWater = arena->used;
+	return arena->base + offset;
+}
+
+char* ArenaPrintf(Arena* arena, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+	if (length < 0) return NULL;
+
+	char* text = (char*)ArenaAlloc(arena, (size_t)length + 1);
+	if (!text) return NULL;
+	va_start(args, format);
+	vsnprintf(text, (size_t)length + 1, format, args);
+	va_end(args);
+	return text;
+}
+
+char* ArenaStrdup(Arena* arena, const char* text)
+{
+	size_t length = strlen(text);
+	char* copy = (char*)ArenaAlloc(arena, length + 1);
+	if (copy) memcpy(copy, text, length + 1);
+	return copy;
+}
+
+void ResetArena(Arena* arena)
+{
+	arena->used = 0;
+	arena->resets++;
+}
+
+// ------ Frame arena ------
+
+bool InitFrameArena(void)
+{
+	frameArena = CreateArena("frame", FRAME_ARENA_SIZE);
+	return frameArena != NULL;
+}
+
+Arena* GetFrameArena(void)
+{
+	return frameArena;
+}
+
+void ResetFrameArena(void)
+{
+	if (frameArena) ResetArena(frameArena);
+}
+
+void ShutdownFrameArena(void)
+{
+	DestroyArena(frameArena);
+	frameArena = NULL;
+}
+
+void LogArenaStats(const Arena* arena)
+{
+	DebugLog(LOG_INFO, "Arena <%s>: %zu of %zu bytes at peak, %lld overflows", arena->name, arena->highWater, arena->capacity, arena->overflows);
+}
@@ -0,0 +1,1102 @@
+#include "asset_cache.h"
+#include "bundle.h"
+#include "platform.h"
+#include "game_alloc.h"
+#include "logger.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Room for stale jobs left behind when the main thread finishes a queued entry itself
+#define DECODE_QUEUE_SIZE (MAX_CACHED_ASSETS * 2)
+
+typedef enum
+{
+	ASSET_TEXTURE,
+	ASSET_FONT,
+	ASSET_ATLAS
+} AssetKind;
+
+typedef enum
+{
+	ASSET_QUEUED,   // Waiting for the worker
+	ASSET_DECODING, // Worker (or a stalled main thread) is decoding it
+	ASSET_DECODED,  // CPU data ready, waiting for GPU upload
+	ASSET_READY     // Uploaded, usable
+} AssetState;
+
+// A READY entry whose file changed on disk goes through the same steps a second time,
+// into the reload fields, while the old data stays in use
+typedef enum
+{
+	RELOAD_NONE,
+	RELOAD_QUEUED,
+	RELOAD_DECODING,
+	RELOAD_DECODED
+} ReloadState;
+
+typedef struct {
+	bool used;
+	unsigned int generation; // Bumped whenever the slot is reused; queued jobs for an older one are skipped
+	AssetKind kind;
+	AssetState state;
+	unsigned int hash;
+	char path[MAX_ASSET_PATH];
+	int refCount;
+	bool prefetched; // Not acquired yet; kept from eviction for ASSET_PREFETCH_GRACE_FRAMES
+	unsigned long long prefetchFrame;
+	long long bytes;
+	unsigned long long lastUse; // Acquire or release, whichever came last; for LRU eviction
+	unsigned int scopes; // Bit per scope that acquired it
+	bool inOpenScope;
+
+	// Decoded CPU-side data, owned by the entry until upload
+	Image image;
+	bool borrowedImage; // image points into the asset bundle and is not freed
+	GlyphInfo* glyphs;
+	Rectangle* glyphRecs;
+	bool opaque; // Textures whose every texel has full alpha (IsTextureOpaque)
+
+	Texture2D texture;
+	Font font;
+	const AtlasDesc* atlasDesc;
+	TextureAtlas* atlas; // Heap allocated so the pointer handed out stays stable
+
+	ReloadState reload;
+	bool reloadAgain; // Changed again while decoding
+	Image reloadImage;
+	bool reloadOpaque;
+	GlyphInfo* reloadGlyphs;
+	Rectangle* reloadRecs;
+	TextureAtlas* reloadAtlas;
+} AssetEntry;
+
+static AssetEntry entries[MAX_CACHED_ASSETS] = { 0 };
+static AssetCacheStats stats = { .budget = ASSET_DEFAULT_VRAM_BUDGET };
+static unsigned long long useClock = 0;
+static unsigned long long frameClock = 0; // CollectUnusedAssets() calls, one per frame
+static bool scopeOpen = false;
+static bool overBudget = false; // Warned about it, everything left is in use
+
+// Decode queue of slots in entries[], with the generation each was queued under
+typedef struct {
+	int index;
+	unsigned int generation;
+} DecodeJob;
+
+static DecodeJob queue[DECODE_QUEUE_SIZE];
+static int queueHead = 0;
+static int queueCount = 0;
+
+static PlatformThread* worker = NULL;
+static PlatformMutex* lock = NULL;
+static PlatformCond* workAvailable = NULL;
+static PlatformCond* workDone = NULL;
+static bool workerQuit = false;
+
+// FNV-1a, only used to skip strcmp on most misses
+static unsigned int HashPath(const char* path)
+{
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)path; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static AssetEntry* FindEntry(AssetKind kind, const char* path)
+{
+	unsigned int hash = HashPath(path);
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == kind && entry->hash == hash && strcmp(entry->path, path) == 0)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static void FreeEntry(AssetEntry* entry);
+static AssetEntry* FindEvictionVictim(void);
+
+static AssetEntry* AllocEntry(AssetKind kind, AssetState state, const char* path, const AtlasDesc* atlasDesc)
+{
+	bool full = true;
+	for (int i = 0; i < MAX_CACHED_ASSETS && full; i++) full = entries[i].used;
+	AssetEntry* victim = full ? FindEvictionVictim() : NULL;
+	if (victim)
+	{
+		// Every slot is taken, make room by evicting like the budget would
+		DebugLog(LOG_INFO, "Asset cache is full, evicting <%s>", victim->path);
+		FreeEntry(victim);
+		stats.evictions++;
+	}
+
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->used)
+		{
+			TextureAtlas* atlas = NULL;
+			if (kind == ASSET_ATLAS)
+			{
+				atlas = (TextureAtlas*)GameAlloc(sizeof(TextureAtlas));
+				memset(atlas, 0, sizeof(TextureAtlas));
+			}
+			// The worker may still pop a job queued for the slot's previous asset
+			PlatformLockMutex(lock);
+			unsigned int generation = entry->generation + 1;
+			memset(entry, 0, sizeof(*entry));
+			entry->used = true;
+			entry->generation = generation;
+			entry->kind = kind;
+			entry->state = state;
+			entry->hash = HashPath(path);
+			snprintf(entry->path, sizeof(entry->path), "%s", path);
+			entry->atlasDesc = atlasDesc;
+			entry->atlas = atlas;
+			PlatformUnlockMutex(lock);
+			return entry;
+		}
+	}
+	DebugLog(LOG_ERROR, "Asset cache is full (%d entries), cannot cache <%s>", MAX_CACHED_ASSETS, path);
+	return NULL;
+}
+
+static long long TextureBytes(Texture2D texture)
+{
+	long long bytes = 0;
+	int width = texture.width;
+	int height = texture.height;
+	for (int level = 0; level < texture.mipmaps; level++)
+	{
+		bytes += GetPixelDataSize(width, height, texture.format);
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return bytes;
+}
+
+typedef struct {
+	char file[MAX_ASSET_PATH];
+	int width; // 0 for the image as it is
+	int height;
+} TextureKey;
+
+// Splits a FormatSizedTextureKey() key back into the file and the size to scale it to
+static TextureKey ParseTextureKey(const char* path)
+{
+	TextureKey key = { 0 };
+	const char* hash = strrchr(path, '#');
+	int length = hash ? (int)(hash - path) : (int)strlen(path);
+	snprintf(key.file, sizeof(key.file), "%.*s", length, path);
+	if (hash && sscanf(hash + 1, "%dx%d", &key.width, &key.height) != 2)
+	{
+		key.width = 0;
+		key.height = 0;
+	}
+	return key;
+}
+
+typedef struct {
+	char file[MAX_ASSET_PATH];
+	int size;
+	bool sdf;
+} FontKey;
+
+// Splits a FormatFontKey() key back into the file and how to bake it
+static FontKey ParseFontKey(const char* path)
+{
+	FontKey key = { 0 };
+	const char* at = strrchr(path, '@');
+	int length = at ? (int)(at - path) : (int)strlen(path);
+	snprintf(key.file, sizeof(key.file), "%.*s", length, path);
+	key.size = FONT_BASE_SIZE;
+	if (at && strcmp(at + 1, "sdf") == 0)
+	{
+		key.sdf = true;
+		key.size = FONT_SDF_SIZE;
+	}
+	else if (at && atoi(at + 1) > 0)
+	{
+		key.size = atoi(at + 1);
+	}
+	return key;
+}
+
+static bool IsScalableFont(const char* file)
+{
+	return strcmp(GetFileExtension(file), ".ttf") == 0 || strcmp(GetFileExtension(file), ".otf") == 0;
+}
+
+static void ReleaseEntryImage(AssetEntry* entry)
+{
+	if (!entry->borrowedImage) UnloadImage(entry->image);
+	entry->image = (Image){ 0 };
+	entry->borrowedImage = false;
+}
+
+// ---------------------- Decoding ----------------------
+// Runs without the lock held; only touches the CPU-side fields of the entry it owns.
+// Assets in the open bundle are already decoded, so this is just an index lookup for them.
+
+static void DecodeEntry(AssetEntry* entry)
+{
+	if (entry->kind == ASSET_TEXTURE)
+	{
+		TextureKey key = ParseTextureKey(entry->path);
+		entry->borrowedImage = GetBundleImage(key.file, &entry->image);
+		if (!entry->borrowedImage) entry->image = LoadImage(key.file);
+		if (key.width > 0 && entry->image.data)
+		{
+			// Scaled once here instead of by the sampler every frame. Smaller than the source
+			// also gets mipmaps, for when it is drawn smaller still until the next variant.
+			if (entry->borrowedImage) entry->image = ImageCopy(entry->image);
+			entry->borrowedImage = false;
+			bool downscaled = key.width < entry->image.width || key.height < entry->image.height;
+			if (key.width != entry->image.width || key.height != entry->image.height) ImageResize(&entry->image, key.width, key.height);
+			if (downscaled) ImageMipmaps(&entry->image);
+		}
+		entry->opaque = IsImageOpaque(&entry->image); // Level 0; scaling and mipmaps keep full alpha
+		return;
+	}
+
+	if (entry->kind == ASSET_ATLAS)
+	{
+		PackAtlasImage(entry->atlasDesc, &entry->image, entry->atlas);
+		return;
+	}
+
+	Font baked;
+	if (GetBundleFont(entry->path, &baked, &entry->image))
+	{
+		entry->borrowedImage = true;
+		entry->glyphs = baked.glyphs;
+		entry->glyphRecs = baked.recs;
+		entry->font.baseSize = baked.baseSize;
+		entry->font.glyphCount = baked.glyphCount;
+		entry->font.glyphPadding = baked.glyphPadding;
+		return;
+	}
+
+	FontKey key = ParseFontKey(entry->path);
+	if (!IsScalableFont(key.file))
+	{
+		return; // Other font formats are decoded by LoadFont() at upload time
+	}
+
+	entry->font.baseSize = key.size;
+	entry->font.glyphCount = FONT_GLYPH_COUNT;
+	entry->font.glyphPadding = FONT_GLYPH_PADDING;
+
+	int codepoints[FONT_GLYPH_COUNT];
+	GetFontCodepoints(codepoints);
+	int dataSize = 0;
+	unsigned char* data = LoadFileData(key.file, &dataSize);
+	if (data)
+	{
+		entry->glyphs = LoadFontData(data, dataSize, key.size, codepoints, FONT_GLYPH_COUNT, key.sdf ? FONT_SDF : FONT_DEFAULT);
+		if (entry->glyphs)
+		{
+			entry->image = GenImageFontAtlas(entry->glyphs, &entry->glyphRecs, FONT_GLYPH_COUNT, key.size, FONT_GLYPH_PADDING, 0);
+		}
+		UnloadFileData(data);
+	}
+}
+
+// Decodes into a scratch entry, so the live one keeps drawing meanwhile
+static void DecodeReload(AssetEntry* entry)
+{
+	AssetEntry scratch = { 0 };
+	scratch.kind = entry->kind;
+	snprintf(scratch.path, sizeof(scratch.path), "%s", entry->path);
+	scratch.atlasDesc = entry->atlasDesc;
+	scratch.atlas = entry->reloadAtlas;
+	DecodeEntry(&scratch);
+	entry->reloadImage = scratch.image;
+	entry->reloadOpaque = scratch.opaque;
+	entry->reloadGlyphs = scratch.glyphs;
+	entry->reloadRecs = scratch.glyphRecs;
+}
+
+static void ReleaseReloadData(AssetEntry* entry)
+{
+	UnloadImage(entry->reloadImage);
+	if (entry->reloadGlyphs) UnloadFontData(entry->reloadGlyphs, FONT_GLYPH_COUNT);
+	MemFree(entry->reloadRecs);
+	GameFree(entry->reloadAtlas);
+	entry->reloadImage = (Image){ 0 };
+	entry->reloadGlyphs = NULL;
+	entry->reloadRecs = NULL;
+	entry->reloadAtlas = NULL;
+}
+
+static int AssetWorker(void* arg)
+{
+	(void)arg;
+	PROFILE_THREAD_NAME("asset worker");
+	PlatformLockMutex(lock);
+	while (!workerQuit)
+	{
+		if (queueCount == 0)
+		{
+			PlatformWaitCond(workAvailable, lock);
+			continue;
+		}
+
+		DecodeJob job = queue[queueHead];
+		queueHead = (queueHead + 1) % DECODE_QUEUE_SIZE;
+		queueCount--;
+		AssetEntry* entry = &entries[job.index];
+		if (!entry->used || entry->generation != job.generation)
+		{
+			continue; // Freed, and maybe reused for another asset, since it was queued
+		}
+		if (entry->reload == RELOAD_QUEUED)
+		{
+			entry->reload = RELOAD_DECODING;
+			PlatformUnlockMutex(lock);
+			PROFILE_BEGIN("assets", "reload decode");
+			DecodeReload(entry);
+			PROFILE_END();
+			PlatformLockMutex(lock);
+			entry->reload = RELOAD_DECODED;
+			continue;
+		}
+		if (entry->state != ASSET_QUEUED)
+		{
+			continue; // The main thread stalled on it and decoded it itself
+		}
+
+		entry->state = ASSET_DECODING;
+		PlatformUnlockMutex(lock);
+		PROFILE_BEGIN("assets", "decode");
+		DecodeEntry(entry);
+		PROFILE_END();
+		PlatformLockMutex(lock);
+		entry->state = ASSET_DECODED;
+		PlatformBroadcastCond(workDone);
+	}
+	PlatformUnlockMutex(lock);
+	return 0;
+}
+
+static void EnqueueEntry(AssetEntry* entry)
+{
+	PlatformLockMutex(lock);
+	if (queueCount == DECODE_QUEUE_SIZE)
+	{
+		PlatformUnlockMutex(lock);
+		return; // Stays queued and is decoded on demand when acquired
+	}
+	queue[(queueHead + queueCount) % DECODE_QUEUE_SIZE] = (DecodeJob){ (int)(entry - entries), entry->generation };
+	queueCount++;
+	PlatformSignalCond(workAvailable);
+	PlatformUnlockMutex(lock);
+}
+
+static void QueueReload(AssetEntry* entry)
+{
+	if (entry->kind == ASSET_ATLAS)
+	{
+		entry->reloadAtlas = (TextureAtlas*)GameAlloc(sizeof(TextureAtlas));
+		memset(entry->reloadAtlas, 0, sizeof(TextureAtlas));
+	}
+	PlatformLockMutex(lock);
+	if (worker && queueCount < DECODE_QUEUE_SIZE)
+	{
+		entry->reload = RELOAD_QUEUED;
+		queue[(queueHead + queueCount) % DECODE_QUEUE_SIZE] = (DecodeJob){ (int)(entry - entries), entry->generation };
+		queueCount++;
+		PlatformSignalCond(workAvailable);
+		PlatformUnlockMutex(lock);
+		return;
+	}
+	PlatformUnlockMutex(lock);
+
+	DecodeReload(entry); // No worker, or no room in the queue
+	entry->reload = RELOAD_DECODED;
+}
+
+// ---------------------- GPU side ----------------------
+// Headless builds never create a GL context: textures only carry their size and a fake id
+// so scene code that reads texture dimensions behaves the same as in the real game.
+
+#if defined(CELISE_HEADLESS)
+static unsigned int nextHeadlessTextureId = 1;
+#endif
+
+static Texture2D UploadTexture(Image image)
+{
+#if defined(CELISE_HEADLESS)
+	if (!image.data) return (Texture2D){ 0 };
+	return (Texture2D){ nextHeadlessTextureId++, image.width, image.height, image.mipmaps, image.format };
+#else
+	return LoadTextureFromImage(image);
+#endif
+}
+
+static Texture2D LoadTextureDirect(const char* path)
+{
+	TextureKey key = ParseTextureKey(path); // Unscaled: only for when the cache is full
+	Image image;
+	if (GetBundleImage(key.file, &image)) return UploadTexture(image);
+
+	image = LoadImage(key.file);
+	Texture2D texture = UploadTexture(image);
+	UnloadImage(image);
+	return texture;
+}
+
+static Font LoadFontDirect(const char* path)
+{
+#if defined(CELISE_HEADLESS)
+	(void)path;
+	return (Font){ 0 };
+#else
+	FontKey key = ParseFontKey(path);
+	if (!IsScalableFont(key.file) || key.sdf) return LoadFont(key.file);
+
+	int codepoints[FONT_GLYPH_COUNT];
+	GetFontCodepoints(codepoints);
+	return LoadFontEx(key.file, key.size, codepoints, FONT_GLYPH_COUNT);
+#endif
+}
+
+static void DestroyTexture(Texture2D texture)
+{
+#if !defined(CELISE_HEADLESS)
+	UnloadTexture(texture);
+#else
+	(void)texture;
+#endif
+}
+
+static void DestroyFont(Font font)
+{
+#if defined(CELISE_HEADLESS)
+	UnloadFontData(font.glyphs, font.glyphCount);
+	MemFree(font.recs);
+#else
+	UnloadFont(font);
+#endif
+}
+
+// --------------------- Upload (main thread) -------------------
+
+static void UploadEntry(AssetEntry* entry)
+{
+	if (entry->kind == ASSET_TEXTURE)
+	{
+		entry->texture = UploadTexture(entry->image);
+		ReleaseEntryImage(entry);
+#if !defined(CELISE_HEADLESS)
+		if (entry->texture.mipmaps > 1) SetTextureFilter(entry->texture, TEXTURE_FILTER_TRILINEAR);
+#endif
+		entry->bytes = TextureBytes(entry->texture);
+		stats.textureCount++;
+	}
+	else if (entry->kind == ASSET_ATLAS)
+	{
+		entry->atlas->texture = UploadTexture(entry->image);
+		ReleaseEntryImage(entry);
+		entry->bytes = TextureBytes(entry->atlas->texture);
+		stats.textureCount++;
+	}
+	else
+	{
+		if (entry->glyphs && entry->image.data)
+		{
+			entry->font.glyphs = entry->glyphs;
+			entry->font.recs = entry->glyphRecs;
+			entry->font.texture = UploadTexture(entry->image);
+			ReleaseEntryImage(entry);
+#if !defined(CELISE_HEADLESS)
+			// Distance fields are sampled between texels; bitmap fonts are drawn at their baked size
+			if (ParseFontKey(entry->path).sdf) SetTextureFilter(entry->font.texture, TEXTURE_FILTER_BILINEAR);
+#endif
+		}
+		else
+		{
+			if (entry->glyphs) UnloadFontData(entry->glyphs, entry->font.glyphCount);
+			if (entry->glyphRecs) MemFree(entry->glyphRecs);
+			ReleaseEntryImage(entry);
+			entry->font = LoadFontDirect(entry->path); // Non-TTF, or the off-thread decode failed
+		}
+		entry->bytes = TextureBytes(entry->font.texture);
+		stats.fontCount++;
+	}
+
+	entry->image = (Image){ 0 };
+	entry->glyphs = NULL;
+	entry->glyphRecs = NULL;
+	PlatformLockMutex(lock); // A stale job for it may be checking the state
+	entry->state = ASSET_READY;
+	PlatformUnlockMutex(lock);
+	stats.bytesResident += entry->bytes;
+}
+
+// New pixels go into the existing texture, so the ids and structs scenes already hold stay
+// valid. raylib cannot give a texture new storage under the same id: an image that changed
+// size is scaled to the old one until the next start.
+static bool UpdateTextureFromImage(Texture2D texture, Image* image, const char* path)
+{
+	if (!image->data)
+	{
+		DebugLog(LOG_WARNING, "Could not reload <%s>, keeping the old version", path);
+		return false;
+	}
+	if (image->width != texture.width || image->height != texture.height)
+	{
+		DebugLog(LOG_WARNING, "<%s> changed from %dx%d to %dx%d, scaled to the old size until restart",
+			path, texture.width, texture.height, image->width, image->height);
+		ImageResize(image, texture.width, texture.height);
+	}
+	ImageFormat(image, texture.format);
+#if !defined(CELISE_HEADLESS)
+	UpdateTexture(texture, image->data); // Level 0 only
+	if (texture.mipmaps > 1) GenTextureMipmaps(&texture);
+#endif
+	return true;
+}
+
+static void ApplyReload(AssetEntry* entry)
+{
+	bool applied = false;
+	if (entry->kind == ASSET_TEXTURE)
+	{
+		applied = UpdateTextureFromImage(entry->texture, &entry->reloadImage, entry->path);
+		if (applied) entry->opaque = entry->reloadOpaque;
+	}
+	else if (entry->kind == ASSET_ATLAS)
+	{
+		// Regions are handed out by value, so they may only move if the whole atlas is rebuilt
+		Texture2D texture = entry->atlas->texture;
+		if (entry->reloadImage.width != texture.width || entry->reloadImage.height != texture.height)
+		{
+			DebugLog(LOG_WARNING, "Atlas <%s> changed layout, restart to see the change", entry->path);
+		}
+		else if (UpdateTextureFromImage(texture, &entry->reloadImage, entry->path))
+		{
+			entry->atlas->regionCount = entry->reloadAtlas->regionCount;
+			memcpy(entry->atlas->regions, entry->reloadAtlas->regions, sizeof(entry->atlas->regions));
+			applied = true;
+		}
+	}
+	else if (entry->reloadGlyphs && entry->reloadRecs && entry->font.glyphCount == FONT_GLYPH_COUNT)
+	{
+		// Glyph arrays are shared with every copy of the Font, so they are overwritten in place
+		Texture2D texture = entry->font.texture;
+		if (entry->reloadImage.width != texture.width || entry->reloadImage.height != texture.height)
+		{
+			DebugLog(LOG_WARNING, "Font <%s> changed atlas size, restart to see the change", entry->path);
+		}
+		else if (UpdateTextureFromImage(texture, &entry->reloadImage, entry->path))
+		{
+			for (int i = 0; i < FONT_GLYPH_COUNT; i++)
+			{
+				UnloadImage(entry->font.glyphs[i].image);
+				entry->font.glyphs[i] = entry->reloadGlyphs[i];
+				entry->font.recs[i] = entry->reloadRecs[i];
+			}
+			MemFree(entry->reloadGlyphs); // The glyph images moved to the font
+			entry->reloadGlyphs = NULL;
+			applied = true;
+		}
+	}
+	else
+	{
+		DebugLog(LOG_WARNING, "Could not reload <%s>, keeping the old version", entry->path);
+	}
+	ReleaseReloadData(entry);
+
+	if (applied)
+	{
+		stats.reloads++;
+		DebugLog(LOG_INFO, "Reloaded <%s>", entry->path);
+	}
+	PlatformLockMutex(lock);
+	entry->reload = RELOAD_NONE;
+	PlatformUnlockMutex(lock);
+	if (entry->reloadAgain)
+	{
+		entry->reloadAgain = false;
+		QueueReload(entry);
+	}
+}
+
+static AssetState GetEntryState(const AssetEntry* entry)
+{
+	PlatformLockMutex(lock);
+	AssetState state = entry->state;
+	PlatformUnlockMutex(lock);
+	return state;
+}
+
+// Brings an in-flight entry to ASSET_READY right now
+static void FinishEntry(AssetEntry* entry)
+{
+	if (GetEntryState(entry) == ASSET_READY) return;
+
+	stats.stalls++;
+	PROFILE_BEGIN("assets", "stall");
+	PlatformLockMutex(lock);
+	if (entry->state == ASSET_QUEUED)
+	{
+		// Still behind other jobs, decode it here rather than wait for the whole queue
+		entry->state = ASSET_DECODING;
+		PlatformUnlockMutex(lock);
+		DecodeEntry(entry);
+		PlatformLockMutex(lock);
+		entry->state = ASSET_DECODED;
+	}
+	while (entry->state != ASSET_DECODED)
+	{
+		PlatformWaitCond(workDone, lock);
+	}
+	PlatformUnlockMutex(lock);
+
+	UploadEntry(entry);
+	PROFILE_END();
+}
+
+static void FreeEntry(AssetEntry* entry)
+{
+	if (entry->kind == ASSET_TEXTURE)
+	{
+		DestroyTexture(entry->texture);
+		stats.textureCount--;
+	}
+	else if (entry->kind == ASSET_ATLAS)
+	{
+		DestroyTexture(entry->atlas->texture);
+		GameFree(entry->atlas);
+		entry->atlas = NULL;
+		stats.textureCount--;
+	}
+	else
+	{
+		DestroyFont(entry->font);
+		stats.fontCount--;
+	}
+	stats.bytesResident -= entry->bytes;
+	PlatformLockMutex(lock);
+	entry->used = false;
+	PlatformUnlockMutex(lock);
+}
+
+// ------------------------ Public API ------------------------
+
+void InitAssetCache(void)
+{
+	lock = PlatformCreateMutex();
+	workAvailable = PlatformCreateCond();
+	workDone = PlatformCreateCond();
+	workerQuit = false;
+	worker = PlatformCreateThread(AssetWorker, NULL);
+	if (!worker)
+	{
+		DebugLog(LOG_WARNING, "Failed to start asset worker, assets will be decoded on demand");
+	}
+}
+
+// Failed loads all come back as texture id 0, or as raylib's default font, so their handles
+// cannot tell the entries apart on release. They stay cached but are never reference counted.
+static bool IsFailedHandle(unsigned int textureId)
+{
+#if defined(CELISE_HEADLESS)
+	return textureId == 0;
+#else
+	return textureId == 0 || textureId == GetFontDefault().texture.id;
+#endif
+}
+
+static bool IsEntryFailed(const AssetEntry* entry)
+{
+	if (entry->kind == ASSET_TEXTURE) return IsFailedHandle(entry->texture.id);
+	if (entry->kind == ASSET_FONT) return IsFailedHandle(entry->font.texture.id);
+	return false; // Atlases are released by pointer
+}
+
+static AssetEntry* AcquireEntry(AssetKind kind, const char* path, const AtlasDesc* atlasDesc)
+{
+	AssetEntry* entry = FindEntry(kind, path);
+	if (entry)
+	{
+		if (GetEntryState(entry) == ASSET_READY) stats.hits++;
+		FinishEntry(entry);
+	}
+	else
+	{
+		stats.misses++;
+		entry = AllocEntry(kind, ASSET_DECODING, path, atlasDesc); // Claimed, so no stale job decodes it too
+		if (!entry) return NULL;
+		DecodeEntry(entry);
+		UploadEntry(entry);
+	}
+
+	if (!IsEntryFailed(entry)) entry->refCount++;
+	entry->prefetched = false;
+	entry->lastUse = ++useClock;
+	if (scopeOpen) entry->inOpenScope = true;
+	return entry;
+}
+
+Texture2D AcquireTexture(const char* path)
+{
+	AssetEntry* entry = AcquireEntry(ASSET_TEXTURE, path, NULL);
+	return entry ? entry->texture : LoadTextureDirect(path);
+}
+
+Texture2D AcquireTextureSized(const char* path, int width, int height)
+{
+	char key[MAX_ASSET_PATH];
+	FormatSizedTextureKey(key, sizeof(key), path, width, height);
+	return AcquireTexture(key);
+}
+
+Font AcquireFont(const char* path)
+{
+	AssetEntry* entry = AcquireEntry(ASSET_FONT, path, NULL);
+	return entry ? entry->font : LoadFontDirect(path);
+}
+
+Font AcquireFontEx(const char* path, int size, bool sdf)
+{
+	char key[MAX_ASSET_PATH];
+	FormatFontKey(key, sizeof(key), path, size, sdf);
+	return AcquireFont(key);
+}
+
+const TextureAtlas* AcquireAtlas(const AtlasDesc* desc)
+{
+	AssetEntry* entry = AcquireEntry(ASSET_ATLAS, desc->name, desc);
+	return entry ? entry->atlas : NULL;
+}
+
+void ReleaseTexture(Texture2D texture)
+{
+	if (IsFailedHandle(texture.id)) return; // Nothing was loaded or counted for it
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == ASSET_TEXTURE && entry->texture.id == texture.id && entry->state == ASSET_READY)
+		{
+			if (entry->refCount > 0) entry->refCount--;
+			entry->lastUse = ++useClock;
+			return;
+		}
+	}
+	// Not ours (e.g. the cache was full when it was loaded)
+	DestroyTexture(texture);
+}
+
+bool IsTextureOpaque(Texture2D texture)
+{
+	for (int i = 0; i < MAX_CACHED_ASSETS && texture.id != 0; i++)
+	{
+		const AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == ASSET_TEXTURE && entry->texture.id == texture.id && entry->state == ASSET_READY)
+		{
+			return entry->opaque;
+		}
+	}
+	return false;
+}
+
+const TextureAtlas* FindTextureAtlas(Texture2D texture)
+{
+	for (int i = 0; i < MAX_CACHED_ASSETS && texture.id != 0; i++)
+	{
+		const AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == ASSET_ATLAS && entry->atlas->texture.id == texture.id && entry->state == ASSET_READY)
+		{
+			return entry->atlas;
+		}
+	}
+	return NULL;
+}
+
+void ReleaseFont(Font font)
+{
+	if (IsFailedHandle(font.texture.id)) return;
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == ASSET_FONT && entry->font.texture.id == font.texture.id && entry->state == ASSET_READY)
+		{
+			if (entry->refCount > 0) entry->refCount--;
+			entry->lastUse = ++useClock;
+			return;
+		}
+	}
+	DestroyFont(font);
+}
+
+void ReleaseAtlas(const TextureAtlas* atlas)
+{
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (entry->used && entry->kind == ASSET_ATLAS && entry->atlas == atlas)
+		{
+			if (entry->refCount > 0) entry->refCount--;
+			entry->lastUse = ++useClock;
+			return;
+		}
+	}
+}
+
+static bool PrefetchEntry(AssetKind kind, const char* path, const AtlasDesc* atlasDesc)
+{
+	if (FindEntry(kind, path)) return true; // Already resident or in flight
+
+	AssetEntry* entry = AllocEntry(kind, ASSET_QUEUED, path, atlasDesc);
+	if (!entry) return false;
+	entry->prefetched = true;
+	entry->prefetchFrame = frameClock;
+	if (worker)
+	{
+		EnqueueEntry(entry);
+	}
+	// Without a worker it simply stays queued and is decoded when acquired
+	return true;
+}
+
+void PrefetchTexture(const char* path)
+{
+	PrefetchEntry(ASSET_TEXTURE, path, NULL);
+}
+
+bool PrefetchTextureSized(const char* path, int width, int height)
+{
+	char key[MAX_ASSET_PATH];
+	FormatSizedTextureKey(key, sizeof(key), path, width, height);
+	return PrefetchEntry(ASSET_TEXTURE, key, NULL);
+}
+
+bool IsTextureReady(const char* path, int width, int height)
+{
+	char key[MAX_ASSET_PATH];
+	FormatSizedTextureKey(key, sizeof(key), path, width, height);
+	AssetEntry* entry = FindEntry(ASSET_TEXTURE, key);
+	return entry && GetEntryState(entry) == ASSET_READY;
+}
+
+void PrefetchFont(const char* path)
+{
+	PrefetchEntry(ASSET_FONT, path, NULL);
+}
+
+void PrefetchFontEx(const char* path, int size, bool sdf)
+{
+	char key[MAX_ASSET_PATH];
+	FormatFontKey(key, sizeof(key), path, size, sdf);
+	PrefetchFont(key);
+}
+
+void PrefetchAtlas(const AtlasDesc* desc)
+{
+	PrefetchEntry(ASSET_ATLAS, desc->name, desc);
+}
+
+void PrefetchAssets(const AssetManifest* manifest)
+{
+	if (!manifest) return;
+	for (int i = 0; i < manifest->textureCount; i++) PrefetchTexture(manifest->textures[i]);
+	for (int i = 0; i < manifest->fontCount; i++) PrefetchFont(manifest->fonts[i]);
+	for (int i = 0; i < manifest->atlasCount; i++) PrefetchAtlas(manifest->atlases[i]);
+}
+
+void PumpAssetUploads(double budgetMs)
+{
+	double start = PlatformGetTime();
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->used) continue;
+
+		PlatformLockMutex(lock);
+		bool decoded = entry->state == ASSET_DECODED;
+		bool reloaded = entry->reload == RELOAD_DECODED;
+		PlatformUnlockMutex(lock);
+		if (!decoded && !reloaded) continue;
+
+		if (decoded) UploadEntry(entry);
+		else ApplyReload(entry);
+		// Always make progress on at least one upload, then respect the budget
+		if ((PlatformGetTime() - start) * 1000.0 >= budgetMs) break;
+	}
+}
+
+static bool UsesFile(const AssetEntry* entry, const char* file)
+{
+	if (entry->kind == ASSET_TEXTURE) return strcmp(ParseTextureKey(entry->path).file, file) == 0;
+	if (entry->kind == ASSET_FONT) return strcmp(ParseFontKey(entry->path).file, file) == 0;
+	for (int i = 0; i < entry->atlasDesc->count; i++)
+	{
+		if (strcmp(entry->atlasDesc->paths[i], file) == 0) return true;
+	}
+	return false;
+}
+
+int ReloadAssetFile(const char* file)
+{
+	int count = 0;
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->used || entry->state != ASSET_READY || !UsesFile(entry, file)) continue;
+
+		// Still in flight: decoding again once it lands picks up the newest file
+		PlatformLockMutex(lock);
+		bool busy = entry->reload != RELOAD_NONE;
+		if (busy && entry->reload != RELOAD_QUEUED) entry->reloadAgain = true;
+		PlatformUnlockMutex(lock);
+		if (!busy) QueueReload(entry);
+		count++;
+	}
+	return count;
+}
+
+// Stale prefetches (successors never entered, variants for a size that is gone) first, then
+// the least recently used
+static AssetEntry* FindEvictionVictim(void)
+{
+	AssetEntry* victim = NULL;
+	PlatformLockMutex(lock); // The worker moves state and reload along
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->used || entry->state != ASSET_READY || entry->refCount > 0 || entry->reload != RELOAD_NONE) continue;
+		if (entry->prefetched && frameClock - entry->prefetchFrame < ASSET_PREFETCH_GRACE_FRAMES) continue;
+		if (!victim || (entry->prefetched && !victim->prefetched) ||
+			(entry->prefetched == victim->prefetched && entry->lastUse < victim->lastUse))
+		{
+			victim = entry;
+		}
+	}
+	PlatformUnlockMutex(lock);
+	return victim;
+}
+
+void CollectUnusedAssets(void)
+{
+	frameClock++;
+	while (stats.bytesResident > stats.budget)
+	{
+		AssetEntry* victim = FindEvictionVictim();
+		if (!victim)
+		{
+			if (!overBudget)
+			{
+				DebugLog(LOG_WARNING, "Assets in use take %.2f MB, over the %.2f MB VRAM budget",
+					stats.bytesResident / (1024.0 * 1024.0), stats.budget / (1024.0 * 1024.0));
+			}
+			overBudget = true;
+			return;
+		}
+		DebugLog(LOG_INFO, "Evicting %s asset <%s> (%.2f MB), %.2f MB over budget",
+			victim->prefetched ? "never acquired" : "unused", victim->path, victim->bytes / (1024.0 * 1024.0), (stats.bytesResident - stats.budget) / (1024.0 * 1024.0));
+		FreeEntry(victim);
+		stats.evictions++;
+	}
+	overBudget = false;
+}
+
+void SetAssetBudget(long long bytes)
+{
+	stats.budget = bytes;
+}
+
+void BeginAssetScope(void)
+{
+	scopeOpen = true;
+}
+
+void EndAssetScope(int scope)
+{
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->inOpenScope) continue;
+		if (scope >= 0 && scope < ASSET_MAX_SCOPES) entry->scopes |= 1u << scope;
+		entry->inOpenScope = false;
+	}
+	scopeOpen = false;
+}
+
+long long GetAssetScopeBytes(int scope)
+{
+	long long bytes = 0;
+	if (scope < 0 || scope >= ASSET_MAX_SCOPES) return 0;
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		const AssetEntry* entry = &entries[i];
+		if (entry->used && entry->state == ASSET_READY && (entry->scopes & (1u << scope))) bytes += entry->bytes;
+	}
+	return bytes;
+}
+
+void UnloadAssetCache(void)
+{
+	if (worker)
+	{
+		PlatformLockMutex(lock);
+		workerQuit = true;
+		PlatformBroadcastCond(workAvailable);
+		PlatformUnlockMutex(lock);
+		PlatformJoinThread(worker);
+		worker = NULL;
+	}
+
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		AssetEntry* entry = &entries[i];
+		if (!entry->used) continue;
+
+		ReleaseReloadData(entry); // The worker is gone, whatever it left is not uploaded
+		if (entry->state == ASSET_READY)
+		{
+			FreeEntry(entry);
+			continue;
+		}
+		// Never uploaded, drop the CPU-side data
+		if (entry->image.data) ReleaseEntryImage(entry);
+		if (entry->glyphs) UnloadFontData(entry->glyphs, entry->font.glyphCount);
+		if (entry->glyphRecs) MemFree(entry->glyphRecs);
+		if (entry->atlas) GameFree(entry->atlas);
+		entry->used = false;
+	}
+	queueHead = 0;
+	queueCount = 0;
+
+	PlatformDestroyCond(workDone);
+	PlatformDestroyCond(workAvailable);
+	PlatformDestroyMutex(lock);
+	lock = NULL;
+}
+
+AssetCacheStats GetAssetCacheStats(void)
+{
+	AssetCacheStats result = stats;
+	for (int i = 0; i < MAX_CACHED_ASSETS; i++)
+	{
+		const AssetEntry* entry = &entries[i];
+		if (entry->used && entry->state == ASSET_READY && entry->refCount == 0) result.bytesUnused += entry->bytes;
+	}
+	return result;
+}
+
+void LogAssetCacheStats(void)
+{
+	AssetCacheStats current = GetAssetCacheStats();
+	DebugLog(LOG_INFO, "Asset cache: %d hits, %d misses, %d stalls, %d reloads, %d evictions, %d textures, %d fonts, %.2f MB resident (%.2f MB unused) of %.2f MB budget",
+		current.hits, current.misses, current.stalls, current.reloads, current.evictions, current.textureCount, current.fontCount,
+		current.bytesResident / (1024.0 * 1024.0), current.bytesUnused / (1024.0 * 1024.0), current.budget / (1024.0 * 1024.0));
+}
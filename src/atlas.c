@@ -0,0 +1,185 @@
+#include "atlas.h"
+#include "bundle.h"
+#include "logger.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int HashName(const char* name)
+{
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)name; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Shelf packing: place images tallest first, left to right, opening a new shelf when a
+// row is full. Returns the packed height, or -1 if the images do not fit in width.
+static int PackShelves(const Image* images, const int* order, int count, int width, Rectangle* rects)
+{
+	int x = ATLAS_PADDING;
+	int y = ATLAS_PADDING;
+	int shelfHeight = 0;
+	for (int i = 0; i < count; i++)
+	{
+		const Image* image = &images[order[i]];
+		if (image->width + 2 * ATLAS_PADDING > width) return -1;
+		if (x + image->width + ATLAS_PADDING > width)
+		{
+			x = ATLAS_PADDING;
+			y += shelfHeight + ATLAS_PADDING;
+			shelfHeight = 0;
+		}
+		rects[order[i]] = (Rectangle){ (float)x, (float)y, (float)image->width, (float)image->height };
+		x += image->width + ATLAS_PADDING;
+		if (image->height > shelfHeight) shelfHeight = image->height;
+	}
+	return y + shelfHeight + ATLAS_PADDING;
+}
+
+bool PackAtlasImage(const AtlasDesc* desc, Image* outImage, TextureAtlas* outAtlas)
+{
+	Image images[ATLAS_MAX_REGIONS] = { 0 };
+	bool borrowed[ATLAS_MAX_REGIONS] = { 0 }; // Bundled RGBA8 images are read in place
+	Rectangle rects[ATLAS_MAX_REGIONS] = { 0 };
+	int order[ATLAS_MAX_REGIONS] = { 0 };
+	int count = desc->count < ATLAS_MAX_REGIONS ? desc->count : ATLAS_MAX_REGIONS;
+
+	for (int i = 0; i < count; i++)
+	{
+		order[i] = i;
+		if (GetBundleImage(desc->paths[i], &images[i]))
+		{
+			borrowed[i] = images[i].format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+			if (!borrowed[i]) images[i] = ImageCopy(images[i]);
+		}
+		else
+		{
+			images[i] = LoadImage(desc->paths[i]);
+		}
+		if (images[i].data && !borrowed[i]) ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+	}
+
+	// Tallest first keeps shelves tight (insertion sort, a handful of images)
+	for (int i = 1; i < count; i++)
+	{
+		int key = order[i];
+		int j = i - 1;
+		while (j >= 0 && images[order[j]].height < images[key].height)
+		{
+			order[j + 1] = order[j];
+			j--;
+		}
+		order[j + 1] = key;
+	}
+
+	// Smallest power-of-two width that gives a roughly square atlas
+	int width = 256;
+	int height = PackShelves(images, order, count, width, rects);
+	while ((height < 0 || height > width) && width < ATLAS_MAX_SIZE)
+	{
+		width *= 2;
+		height = PackShelves(images, order, count, width, rects);
+	}
+	if (height < 0 || height > ATLAS_MAX_SIZE)
+	{
+		DebugLog(LOG_ERROR, "Atlas <%s> does not fit in %dx%d", desc->name, ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+		for (int i = 0; i < count; i++)
+		{
+			if (!borrowed[i]) UnloadImage(images[i]);
+		}
+		return false;
+	}
+
+	Image atlas = GenImageColor(width, height, BLANK);
+	unsigned char* pixels = (unsigned char*)atlas.data;
+	outAtlas->regionCount = count;
+	for (int i = 0; i < count; i++)
+	{
+		AtlasRegion* region = &outAtlas->regions[i];
+		snprintf(region->name, sizeof(region->name), "%s", desc->paths[i]);
+		region->hash = HashName(region->name);
+		region->rect = rects[i];
+		region->opaque = IsImageOpaque(&images[i]);
+
+		const unsigned char* source = (const unsigned char*)images[i].data;
+		if (!source) continue;
+		for (int row = 0; row < images[i].height; row++)
+		{
+			memcpy(pixels + (((int)rects[i].y + row) * width + (int)rects[i].x) * 4,
+				source + row * images[i].width * 4,
+				(size_t)images[i].width * 4);
+		}
+		if (!borrowed[i]) UnloadImage(images[i]);
+	}
+
+	*outImage = atlas;
+	return true;
+}
+
+static const AtlasRegion* FindAtlasRegion(const TextureAtlas* atlas, const char* path)
+{
+	unsigned int hash = HashName(path);
+	for (int i = 0; i < atlas->regionCount; i++)
+	{
+		if (atlas->regions[i].hash == hash && strcmp(atlas->regions[i].name, path) == 0) return &atlas->regions[i];
+	}
+	DebugLog(LOG_WARNING, "<%s> is not part of the atlas", path);
+	return NULL;
+}
+
+Rectangle GetAtlasRegion(const TextureAtlas* atlas, const char* path)
+{
+	const AtlasRegion* region = FindAtlasRegion(atlas, path);
+	return region ? region->rect : (Rectangle){ 0 };
+}
+
+bool IsAtlasRegionOpaque(const TextureAtlas* atlas, const char* path)
+{
+	const AtlasRegion* region = FindAtlasRegion(atlas, path);
+	return region && region->opaque;
+}
+
+bool IsAtlasSourceOpaque(const TextureAtlas* atlas, Rectangle source)
+{
+	// Negative sizes flip the quad but sample the same pixels
+	float right = source.x + fabsf(source.width);
+	float bottom = source.y + fabsf(source.height);
+	for (int i = 0; i < atlas->regionCount; i++)
+	{
+		Rectangle rect = atlas->regions[i].rect;
+		if (source.x >= rect.x && source.y >= rect.y && right <= rect.x + rect.width && bottom <= rect.y + rect.height)
+		{
+			return atlas->regions[i].opaque;
+		}
+	}
+	return false;
+}
+
+bool IsImageOpaque(const Image* image)
+{
+	switch (image->format)
+	{
+	case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+	case PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+	case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+		return image->data != NULL;
+	case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+		break;
+	default:
+		return false;
+	}
+
+	const unsigned char* pixels = (const unsigned char*)image->data;
+	if (!pixels) return false;
+	size_t count = (size_t)image->width * image->height;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (pixels[i * 4 + 3] != 255) return false;
+	}
+	return true;
+}
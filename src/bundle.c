@@ -0,0 +1,157 @@
+#include "bundle.h"
+#include "platform.h"
+#include "logger.h"
+#include <string.h>
+
+static PlatformMappedFile* mapping = NULL;
+static const unsigned char* bundleBase = NULL;
+static size_t bundleSize = 0;
+static const BundleEntry* bundleIndex = NULL;
+static int entryCount = 0;
+
+static bool ValidateBundle(const char* path)
+{
+	const BundleHeader* header = (const BundleHeader*)bundleBase;
+	if (bundleSize < sizeof(BundleHeader) || header->magic != BUNDLE_MAGIC)
+	{
+		DebugLog(LOG_ERROR, "<%s> is not an asset bundle", path);
+		return false;
+	}
+	if (header->version != BUNDLE_VERSION)
+	{
+		DebugLog(LOG_ERROR, "Asset bundle <%s> is version %u, expected %d; rebuild it with CeliseBundle", path, header->version, BUNDLE_VERSION);
+		return false;
+	}
+	if ((uint64_t)header->entryCount * sizeof(BundleEntry) > bundleSize - sizeof(BundleHeader))
+	{
+		DebugLog(LOG_ERROR, "Asset bundle <%s> is truncated", path);
+		return false;
+	}
+
+	const BundleEntry* entries = (const BundleEntry*)(bundleBase + sizeof(BundleHeader));
+	for (uint32_t i = 0; i < header->entryCount; i++)
+	{
+		const BundleEntry* entry = &entries[i];
+		if (entry->offset > bundleSize || entry->size > bundleSize - entry->offset || entry->path[BUNDLE_MAX_PATH - 1] != '\0')
+		{
+			DebugLog(LOG_ERROR, "Asset bundle <%s> has a corrupt entry (%u)", path, i);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool OpenAssetBundle(const char* path)
+{
+	CloseAssetBundle();
+
+	const void* data = NULL;
+	mapping = PlatformMapFile(path, &data, &bundleSize);
+	if (!mapping) return false;
+
+	bundleBase = (const unsigned char*)data;
+	if (!ValidateBundle(path))
+	{
+		CloseAssetBundle();
+		return false;
+	}
+
+	bundleIndex = (const BundleEntry*)(bundleBase + sizeof(BundleHeader));
+	entryCount = (int)((const BundleHeader*)bundleBase)->entryCount;
+	DebugLog(LOG_INFO, "Opened asset bundle <%s>: %d assets, %zu KB", path, entryCount, bundleSize / 1024);
+	return true;
+}
+
+bool OpenInstalledAssetBundle(void)
+{
+	if (OpenAssetBundle(ASSET_BUNDLE_FILE)) return true;
+	return OpenAssetBundle(TextFormat("%s%s", GetApplicationDirectory(), ASSET_BUNDLE_FILE));
+}
+
+void CloseAssetBundle(void)
+{
+	PlatformUnmapFile(mapping);
+	mapping = NULL;
+	bundleBase = NULL;
+	bundleSize = 0;
+	bundleIndex = NULL;
+	entryCount = 0;
+}
+
+bool IsAssetBundleOpen(void)
+{
+	return mapping != NULL;
+}
+
+const BundleEntry* FindBundleEntry(const char* path)
+{
+	if (!bundleIndex) return NULL;
+
+	// Lower bound on the hash, then compare paths across any collisions
+	uint32_t hash = HashBundlePath(path);
+	int low = 0;
+	int high = entryCount;
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (bundleIndex[mid].hash < hash) low = mid + 1;
+		else high = mid;
+	}
+	for (int i = low; i < entryCount && bundleIndex[i].hash == hash; i++)
+	{
+		if (strcmp(bundleIndex[i].path, path) == 0) return &bundleIndex[i];
+	}
+	return NULL;
+}
+
+static bool ViewPixels(const BundleEntry* entry, uint64_t offset, Image* image)
+{
+	uint64_t pixelBytes = (uint64_t)GetPixelDataSize(entry->width, entry->height, entry->pixelFormat);
+	if (entry->width <= 0 || entry->height <= 0 || offset > entry->size || pixelBytes > entry->size - offset)
+	{
+		DebugLog(LOG_ERROR, "Bundled asset <%s> has a bad payload size", entry->path);
+		return false;
+	}
+
+	*image = (Image){ (void*)(bundleBase + entry->offset + offset), entry->width, entry->height, 1, entry->pixelFormat };
+	return true;
+}
+
+bool GetBundleImage(const char* path, Image* image)
+{
+	const BundleEntry* entry = FindBundleEntry(path);
+	if (!entry || entry->format != BUNDLE_IMAGE) return false;
+	return ViewPixels(entry, 0, image);
+}
+
+bool GetBundleFont(const char* path, Font* font, Image* atlas)
+{
+	const BundleEntry* entry = FindBundleEntry(path);
+	if (!entry || entry->format != BUNDLE_FONT || entry->glyphCount <= 0) return false;
+
+	uint64_t glyphBytes = (uint64_t)entry->glyphCount * sizeof(BundleGlyph);
+	if (!ViewPixels(entry, glyphBytes, atlas)) return false;
+
+	const BundleGlyph* source = (const BundleGlyph*)(bundleBase + entry->offset);
+	*font = (Font){ 0 };
+	font->baseSize = entry->baseSize;
+	font->glyphCount = entry->glyphCount;
+	font->glyphPadding = entry->glyphPadding;
+	font->glyphs = (GlyphInfo*)MemAlloc(sizeof(GlyphInfo) * entry->glyphCount);
+	font->recs = (Rectangle*)MemAlloc(sizeof(Rectangle) * entry->glyphCount);
+	for (int i = 0; i < entry->glyphCount; i++)
+	{
+		// Per-glyph images are only needed to re-pack the atlas, which is already baked
+		font->glyphs[i] = (GlyphInfo){ source[i].value, source[i].offsetX, source[i].offsetY, source[i].advanceX, { 0 } };
+		font->recs[i] = (Rectangle){ source[i].x, source[i].y, source[i].width, source[i].height };
+	}
+	return true;
+}
+
+const void* GetBundleClips(const char* path, uint64_t* size)
+{
+	const BundleEntry* entry = FindBundleEntry(path);
+	if (!entry || entry->format != BUNDLE_CLIPS) return NULL;
+	*size = entry->size;
+	return bundleBase + entry->offset;
+}
@@ -0,0 +1,223 @@
+#include "ecs.h"
+#include "game_alloc.h"
+#include "logger.h"
+#include "jobs.h"
+#include <string.h>
+
+#define ENTITY_SLOT(id) ((int)((id) & ENTITY_INDEX_MASK))
+#define ENTITY_GENERATION(id) ((id) >> ENTITY_INDEX_BITS)
+
+static void* AllocComponent(int capacity, size_t size)
+{
+	void* data = GameAlloc((size_t)capacity * size);
+	if (data) memset(data, 0, (size_t)capacity * size);
+	return data;
+}
+
+EntityWorld* CreateEntityWorld(int capacity)
+{
+	if (capacity > (int)ENTITY_INDEX_MASK) capacity = (int)ENTITY_INDEX_MASK;
+
+	EntityWorld* world = (EntityWorld*)GameAlloc(sizeof(EntityWorld));
+	if (!world)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate memory for EntityWorld");
+		return NULL;
+	}
+	memset(world, 0, sizeof(EntityWorld));
+	world->capacity = capacity;
+
+	world->ids = AllocComponent(capacity, sizeof(EntityId));
+	world->posX = AllocComponent(capacity, sizeof(float));
+	world->posY = AllocComponent(capacity, sizeof(float));
+	world->prevX = AllocComponent(capacity, sizeof(float));
+	world->prevY = AllocComponent(capacity, sizeof(float));
+	world->velX = AllocComponent(capacity, sizeof(float));
+	world->velY = AllocComponent(capacity, sizeof(float));
+	world->animTimer = AllocComponent(capacity, sizeof(float));
+	world->frameTime = AllocComponent(capacity, sizeof(float));
+	world->animFrame = AllocComponent(capacity, sizeof(int));
+	world->frameCount = AllocComponent(capacity, sizeof(int));
+	world->direction = AllocComponent(capacity, sizeof(float));
+	world->state = AllocComponent(capacity, sizeof(unsigned char));
+	world->sheetX = AllocComponent(capacity, sizeof(float));
+	world->sheetY = AllocComponent(capacity, sizeof(float));
+	world->frameWidth = AllocComponent(capacity, sizeof(float));
+	world->frameHeight = AllocComponent(capacity, sizeof(float));
+	world->sourceRects = AllocComponent(capacity, sizeof(Rectangle));
+	world->textures = AllocComponent(capacity, sizeof(Texture2D));
+	world->flags = AllocComponent(capacity, sizeof(unsigned char));
+	world->animations = AllocComponent(capacity, sizeof(AnimationState));
+	world->spriteRects = AllocComponent(capacity, sizeof(Rectangle));
+	world->names = AllocComponent(capacity, sizeof(const char*));
+
+	world->denseOf = AllocComponent(capacity, sizeof(int));
+	world->generations = AllocComponent(capacity, sizeof(unsigned short));
+	world->freeSlots = AllocComponent(capacity, sizeof(int));
+	for (int i = 0; i < capacity; i++)
+	{
+		world->denseOf[i] = -1;
+		world->generations[i] = 1; // Generation 0 is never handed out, so NULL_ENTITY stays invalid
+	}
+	return world;
+}
+
+void DestroyEntityWorld(EntityWorld* world)
+{
+	if (!world) return;
+	GameFree(world->ids);
+	GameFree(world->posX);
+	GameFree(world->posY);
+	GameFree(world->prevX);
+	GameFree(world->prevY);
+	GameFree(world->velX);
+	GameFree(world->velY);
+	GameFree(world->animTimer);
+	GameFree(world->frameTime);
+	GameFree(world->animFrame);
+	GameFree(world->frameCount);
+	GameFree(world->direction);
+	GameFree(world->state);
+	GameFree(world->sheetX);
+	GameFree(world->sheetY);
+	GameFree(world->frameWidth);
+	GameFree(world->frameHeight);
+	GameFree(world->sourceRects);
+	GameFree(world->textures);
+	GameFree(world->flags);
+	GameFree(world->animations);
+	GameFree(world->spriteRects);
+	GameFree(world->names);
+	GameFree(world->denseOf);
+	GameFree(world->generations);
+	GameFree(world->freeSlots);
+	GameFree(world);
+}
+
+EntityId SpawnEntity(EntityWorld* world, Vector2 position, const char* name)
+{
+	if (world->count == world->capacity)
+	{
+		DebugLog(LOG_ERROR, "Entity world is full (%d entities)", world->capacity);
+		return NULL_ENTITY;
+	}
+
+	int slot = world->freeCount > 0 ? world->freeSlots[--world->freeCount] : world->nextSlot++;
+	EntityId id = ((EntityId)world->generations[slot] << ENTITY_INDEX_BITS) | (EntityId)slot;
+
+	int i = world->count++;
+	world->denseOf[slot] = i;
+	world->ids[i] = id;
+	world->posX[i] = position.x;
+	world->posY[i] = position.y;
+	world->prevX[i] = position.x;
+	world->prevY[i] = position.y;
+	world->velX[i] = 0.0f;
+	world->velY[i] = 0.0f;
+	world->animTimer[i] = 0.0f;
+	world->frameTime[i] = 0.1f;
+	world->animFrame[i] = 0;
+	world->frameCount[i] = 1;
+	world->direction[i] = -1.0f;
+	world->state[i] = IDLE;
+	world->sheetX[i] = 0.0f;
+	world->sheetY[i] = 0.0f;
+	world->frameWidth[i] = 0.0f;
+	world->frameHeight[i] = 0.0f;
+	world->sourceRects[i] = (Rectangle) { 0 };
+	world->textures[i] = (Texture2D) { 0 };
+	world->flags[i] = 0;
+	world->animations[i] = (AnimationState) { 0 };
+	world->spriteRects[i] = (Rectangle) { 0 };
+	world->names[i] = name;
+	return id;
+}
+
+void DespawnEntity(EntityWorld* world, EntityId entity)
+{
+	int i = GetEntityIndex(world, entity);
+	if (i < 0) return;
+
+	if (world->animations[i].set) world->animatedCount--;
+
+	// Keep the arrays dense: move the last entity into the hole
+	int last = world->count - 1;
+	if (i != last)
+	{
+		world->ids[i] = world->ids[last];
+		world->posX[i] = world->posX[last];
+		world->posY[i] = world->posY[last];
+		world->prevX[i] = world->prevX[last];
+		world->prevY[i] = world->prevY[last];
+		world->velX[i] = world->velX[last];
+		world->velY[i] = world->velY[last];
+		world->animTimer[i] = world->animTimer[last];
+		world->frameTime[i] = world->frameTime[last];
+		world->animFrame[i] = world->animFrame[last];
+		world->frameCount[i] = world->frameCount[last];
+		world->direction[i] = world->direction[last];
+		world->state[i] = world->state[last];
+		world->sheetX[i] = world->sheetX[last];
+		world->sheetY[i] = world->sheetY[last];
+		world->frameWidth[i] = world->frameWidth[last];
+		world->frameHeight[i] = world->frameHeight[last];
+		world->sourceRects[i] = world->sourceRects[last];
+		world->textures[i] = world->textures[last];
+		world->flags[i] = world->flags[last];
+		world->animations[i] = world->animations[last];
+		world->spriteRects[i] = world->spriteRects[last];
+		world->names[i] = world->names[last];
+		world->denseOf[ENTITY_SLOT(world->ids[i])] = i;
+	}
+	world->count--;
+
+	int slot = ENTITY_SLOT(entity);
+	world->denseOf[slot] = -1;
+	world->generations[slot] = (unsigned short)((world->generations[slot] + 1) & ENTITY_GENERATION_MASK);
+	if (world->generations[slot] == 0) world->generations[slot] = 1;
+	world->freeSlots[world->freeCount++] = slot;
+}
+
+int GetEntityIndex(const EntityWorld* world, EntityId entity)
+{
+	int slot = ENTITY_SLOT(entity);
+	if (entity == NULL_ENTITY || slot >= world->nextSlot) return -1;
+	if (world->generations[slot] != ENTITY_GENERATION(entity)) return -1;
+	return world->denseOf[slot];
+}
+
+bool IsEntityAlive(const EntityWorld* world, EntityId entity)
+{
+	return GetEntityIndex(world, entity) >= 0;
+}
+
+void SaveEntityPositions(EntityWorld* world)
+{
+	memcpy(world->prevX, world->posX, (size_t)world->count * sizeof(float));
+	memcpy(world->prevY, world->posY, (size_t)world->count * sizeof(float));
+}
+
+typedef struct {
+	EntityWorld* world;
+	float dt;
+} MoveJob;
+
+static void MoveEntityRange(void* data, int begin, int end)
+{
+	const MoveJob* job = (const MoveJob*)data;
+	float* posX = job->world->posX;
+	float* posY = job->world->posY;
+	const float* velX = job->world->velX;
+	const float* velY = job->world->velY;
+	for (int i = begin; i < end; i++)
+	{
+		posX[i] += velX[i] * job->dt;
+		posY[i] += velY[i] * job->dt;
+	}
+}
+
+void MoveEntities(EntityWorld* world, float dt)
+{
+	MoveJob job = { world, dt };
+	ParallelFor(MoveEntityRange, &job, world->count, ENTITY_JOB_GRAIN);
+}
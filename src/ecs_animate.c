@@ -0,0 +1,246 @@
+#include "ecs.h"
+#include "animation.h"
+#include "platform.h"
+#include "logger.h"
+#include "jobs.h"
+#include <string.h>
+
+// Animation system: advance frame timers, wrap frame indices and write the source
+// rectangle of every entity's current frame, ready to hand to BatchSprite().
+// The vector kernels produce bit-identical results to the scalar one: the frame
+// wrap is computed as next - trunc(next / count) * count in float, which is exact
+// for frame counts this small.
+
+#if defined(PLATFORM_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define ANIMATION_TARGET(isa)
+#else
+#define ANIMATION_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+typedef void (*AnimationKernelFunc)(EntityWorld* world, int first, int count, float dt);
+
+static void AnimateScalar(EntityWorld* world, int first, int count, float dt)
+{
+	for (int i = first; i < count; i++)
+	{
+		if (world->state[i] != IDLE) // Idle entities hold their pose
+		{
+			world->animTimer[i] += dt;
+			if (world->animTimer[i] >= world->frameTime[i])
+			{
+				world->animFrame[i] = (world->animFrame[i] + 1) % world->frameCount[i];
+				world->animTimer[i] = 0.0f;
+			}
+		}
+
+		world->sourceRects[i] = (Rectangle) {
+			world->sheetX[i] + (float)world->animFrame[i] * world->frameWidth[i],
+			world->sheetY[i],
+			world->frameWidth[i] * world->direction[i],
+			world->frameHeight[i]
+		};
+	}
+}
+
+#if defined(PLATFORM_X86)
+
+ANIMATION_TARGET("sse2")
+static void AnimateSSE2(EntityWorld* world, int first, int count, float dt)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 step = _mm_set1_ps(dt);
+	int i = first;
+	for (; i + 4 <= count; i += 4)
+	{
+		int states;
+		memcpy(&states, &world->state[i], sizeof(states));
+		__m128i state = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(states), zero), zero);
+		__m128 active = _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(state, zero), _mm_set1_epi32(-1)));
+
+		__m128 timer = _mm_loadu_ps(&world->animTimer[i]);
+		timer = _mm_add_ps(timer, _mm_and_ps(active, step));
+		__m128 wrap = _mm_and_ps(active, _mm_cmpge_ps(timer, _mm_loadu_ps(&world->frameTime[i])));
+
+		__m128 frame = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&world->animFrame[i]));
+		__m128 frames = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&world->frameCount[i]));
+		__m128 next = _mm_add_ps(frame, one);
+		__m128 laps = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(next, frames)));
+		next = _mm_sub_ps(next, _mm_mul_ps(laps, frames));
+		frame = _mm_or_ps(_mm_and_ps(wrap, next), _mm_andnot_ps(wrap, frame));
+
+		_mm_storeu_ps(&world->animTimer[i], _mm_andnot_ps(wrap, timer));
+		_mm_storeu_si128((__m128i*)&world->animFrame[i], _mm_cvttps_epi32(frame));
+
+		__m128 width = _mm_loadu_ps(&world->frameWidth[i]);
+		__m128 x = _mm_add_ps(_mm_loadu_ps(&world->sheetX[i]), _mm_mul_ps(frame, width));
+		__m128 y = _mm_loadu_ps(&world->sheetY[i]);
+		__m128 w = _mm_mul_ps(width, _mm_loadu_ps(&world->direction[i]));
+		__m128 h = _mm_loadu_ps(&world->frameHeight[i]);
+		_MM_TRANSPOSE4_PS(x, y, w, h);
+		_mm_storeu_ps(&world->sourceRects[i].x, x);
+		_mm_storeu_ps(&world->sourceRects[i + 1].x, y);
+		_mm_storeu_ps(&world->sourceRects[i + 2].x, w);
+		_mm_storeu_ps(&world->sourceRects[i + 3].x, h);
+	}
+	AnimateScalar(world, i, count, dt);
+}
+
+ANIMATION_TARGET("avx2")
+static void AnimateAVX2(EntityWorld* world, int first, int count, float dt)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 step = _mm256_set1_ps(dt);
+	int i = first;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256i state = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&world->state[i]));
+		__m256 active = _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(state, zero), _mm256_set1_epi32(-1)));
+
+		__m256 timer = _mm256_loadu_ps(&world->animTimer[i]);
+		timer = _mm256_add_ps(timer, _mm256_and_ps(active, step));
+		__m256 wrap = _mm256_and_ps(active, _mm256_cmp_ps(timer, _mm256_loadu_ps(&world->frameTime[i]), _CMP_GE_OQ));
+
+		__m256 frame = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)&world->animFrame[i]));
+		__m256 frames = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)&world->frameCount[i]));
+		__m256 next = _mm256_add_ps(frame, one);
+		__m256 laps = _mm256_round_ps(_mm256_div_ps(next, frames), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+		next = _mm256_sub_ps(next, _mm256_mul_ps(laps, frames));
+		frame = _mm256_blendv_ps(frame, next, wrap);
+
+		_mm256_storeu_ps(&world->animTimer[i], _mm256_andnot_ps(wrap, timer));
+		_mm256_storeu_si256((__m256i*)&world->animFrame[i], _mm256_cvttps_epi32(frame));
+
+		__m256 width = _mm256_loadu_ps(&world->frameWidth[i]);
+		__m256 x = _mm256_add_ps(_mm256_loadu_ps(&world->sheetX[i]), _mm256_mul_ps(frame, width));
+		__m256 y = _mm256_loadu_ps(&world->sheetY[i]);
+		__m256 w = _mm256_mul_ps(width, _mm256_loadu_ps(&world->direction[i]));
+		__m256 h = _mm256_loadu_ps(&world->frameHeight[i]);
+
+		// 8 x {x, y, w, h} -> 8 Rectangles. The unpacks/shuffles work within 128-bit
+		// lanes, so rows come out as (0|4, 1|5, 2|6, 3|7) and the final permutes reorder them.
+		__m256 xy0 = _mm256_unpacklo_ps(x, y);
+		__m256 xy1 = _mm256_unpackhi_ps(x, y);
+		__m256 wh0 = _mm256_unpacklo_ps(w, h);
+		__m256 wh1 = _mm256_unpackhi_ps(w, h);
+		__m256 r04 = _mm256_shuffle_ps(xy0, wh0, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 r15 = _mm256_shuffle_ps(xy0, wh0, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 r26 = _mm256_shuffle_ps(xy1, wh1, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 r37 = _mm256_shuffle_ps(xy1, wh1, _MM_SHUFFLE(3, 2, 3, 2));
+		_mm256_storeu_ps(&world->sourceRects[i].x, _mm256_permute2f128_ps(r04, r15, 0x20));
+		_mm256_storeu_ps(&world->sourceRects[i + 2].x, _mm256_permute2f128_ps(r26, r37, 0x20));
+		_mm256_storeu_ps(&world->sourceRects[i + 4].x, _mm256_permute2f128_ps(r04, r15, 0x31));
+		_mm256_storeu_ps(&world->sourceRects[i + 6].x, _mm256_permute2f128_ps(r26, r37, 0x31));
+	}
+	AnimateScalar(world, i, count, dt);
+}
+
+#endif
+
+static AnimationKernelFunc kernels[] = {
+	AnimateScalar,
+#if defined(PLATFORM_X86)
+	AnimateSSE2,
+	AnimateAVX2
+#endif
+};
+
+static AnimationKernel activeKernel = ANIMATION_KERNEL_SCALAR;
+static bool kernelSelected = false;
+
+AnimationKernel SetAnimationKernel(AnimationKernel kernel)
+{
+	PlatformCpuFeatures cpu = PlatformGetCpuFeatures();
+	if (kernel == ANIMATION_KERNEL_AVX2 && !cpu.avx2) kernel = ANIMATION_KERNEL_SSE2;
+	if (kernel == ANIMATION_KERNEL_SSE2 && !cpu.sse2) kernel = ANIMATION_KERNEL_SCALAR;
+
+	activeKernel = kernel;
+	kernelSelected = true;
+	return kernel;
+}
+
+const char* GetAnimationKernelName(AnimationKernel kernel)
+{
+	switch (kernel)
+	{
+	case ANIMATION_KERNEL_AVX2: return "avx2";
+	case ANIMATION_KERNEL_SSE2: return "sse2";
+	default: return "scalar";
+	}
+}
+
+// Entities with an AnimationSet (animation.h): overrides what the kernel wrote with the
+// current frame of their state's clip. A state change restarts the clip; each frame has
+// its own duration, and clips that do not loop hold their last frame.
+static void PlayClips(EntityWorld* world, int first, int count, float dt)
+{
+	for (int i = first; i < count; i++)
+	{
+		AnimationState* animation = &world->animations[i];
+		const AnimationSet* set = animation->set;
+		if (!set) continue;
+
+		const AnimationClip* clip = &set->clips[world->state[i]];
+		if (animation->clipState != world->state[i])
+		{
+			animation->clipState = world->state[i];
+			animation->frame = 0;
+			animation->timer = 0.0f;
+		}
+		else if (clip->frameCount > 0)
+		{
+			animation->timer += dt;
+			float duration = set->frames[clip->firstFrame + animation->frame].duration;
+			while (duration > 0.0f && animation->timer >= duration)
+			{
+				if (animation->frame + 1 < clip->frameCount) animation->frame++;
+				else if (clip->loop) animation->frame = 0;
+				else
+				{
+					animation->timer = duration;
+					break;
+				}
+				animation->timer -= duration;
+				duration = set->frames[clip->firstFrame + animation->frame].duration;
+			}
+		}
+		world->animFrame[i] = animation->frame;
+		if (clip->frameCount == 0) continue;
+
+		// Flipped frames mirror inside the cell, so the character does not shift on turning
+		const AnimationFrame* frame = &set->frames[clip->firstFrame + animation->frame];
+		float x = world->direction[i] < 0.0f ? set->cellSize.x - frame->offset.x - frame->source.width : frame->offset.x;
+		world->sourceRects[i] = (Rectangle) {
+			frame->source.x, frame->source.y, frame->source.width * world->direction[i], frame->source.height
+		};
+		world->spriteRects[i] = (Rectangle) { x, frame->offset.y, frame->source.width, frame->source.height };
+	}
+}
+
+typedef struct {
+	EntityWorld* world;
+	float dt;
+	AnimationKernelFunc kernel;
+} AnimateJob;
+
+static void AnimateEntityRange(void* data, int begin, int end)
+{
+	const AnimateJob* job = (const AnimateJob*)data;
+	job->kernel(job->world, begin, end, job->dt);
+	if (job->world->animatedCount > 0) PlayClips(job->world, begin, end, job->dt);
+}
+
+void AnimateEntities(EntityWorld* world, float dt)
+{
+	if (!kernelSelected)
+	{
+		SetAnimationKernel(ANIMATION_KERNEL_AVX2);
+		DebugLog(LOG_INFO, "Animation kernel: %s", GetAnimationKernelName(activeKernel));
+	}
+	AnimateJob job = { world, dt, kernels[activeKernel] };
+	ParallelFor(AnimateEntityRange, &job, world->count, ENTITY_JOB_GRAIN);
+}
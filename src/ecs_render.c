@@ -0,0 +1,35 @@
+#include "ecs.h"
+#include "spatial_hash.h"
+#include "world_camera.h"
+#include "sprite_batch.h"
+#include "arena.h"
+
+int DrawVisibleEntities(const EntityWorld* world, const SpatialHash* hash, Camera2D camera, float alpha)
+{
+	int* visible = (int*)ArenaAlloc(GetFrameArena(), sizeof(int) * (hash->count > 0 ? hash->count : 1));
+	if (!visible) return 0;
+
+	int count = QueryEntitiesInRect(hash, world, GetCameraView(camera), visible, hash->count);
+	int drawn = 0;
+	for (int v = 0; v < count; v++)
+	{
+		int i = visible[v];
+		if (world->textures[i].id == 0) continue; // Triggers and other invisible entities
+
+		Rectangle bounds = {
+			world->prevX[i] + (world->posX[i] - world->prevX[i]) * alpha,
+			world->prevY[i] + (world->posY[i] - world->prevY[i]) * alpha,
+			world->frameWidth[i],
+			world->frameHeight[i]
+		};
+		if (world->animations[i].set)
+		{
+			// Trimmed frame: only its own pixels inside the cell
+			const Rectangle sprite = world->spriteRects[i];
+			bounds = (Rectangle) { bounds.x + sprite.x, bounds.y + sprite.y, sprite.width, sprite.height };
+		}
+		BatchSprite(world->textures[i], world->sourceRects[i], WorldToScreenRect(camera, bounds), SPRITE_LAYER_CHARACTERS, WHITE);
+		drawn++;
+	}
+	return drawn;
+}
@@ -0,0 +1,185 @@
+#include "game.h"
+#include "scenes.h"
+#include "input.h"
+#include "simulation.h"
+#include "platform.h"
+#include "sprite_batch.h"
+#include "text.h"
+#include "ecs.h"
+#include "spatial_hash.h"
+#include "arena.h"
+#include "logger.h"
+#include "profiler.h"
+#include "game_alloc.h"
+
+static const char* spriteAtlasPaths[] = {
+	"hud.png", "portrait.png", "portrait_frame.png", "ui_frame.png",
+	"character/walking_sprite_sheet.png", "character/running_sprite_sheet.png"
+};
+const AtlasDesc spriteAtlas = { "sprites", spriteAtlasPaths, 6 };
+
+static EntityWorld* world = NULL;
+static Player player = { 0 };
+static Player_2 playerData = { 0 };
+static Attributes playerAttributes = { 10, 10, 10, 10, 10, 10 };
+static char characterName[CHARACTER_NAME_MAX] = "Celise";
+static long long clockOffsetMinutes = 6 * 60;
+static SpatialHash* spatialHash = NULL;
+
+static SceneUpdateTiming sceneTimings[SCENE_ID_COUNT] = { 0 };
+
+static void RecordSceneUpdate(Scene* scene, double seconds)
+{
+	SceneUpdateTiming* timing = &sceneTimings[scene->id];
+	timing->scene_name = scene->scene_name;
+	timing->ticks++;
+	timing->seconds += seconds;
+}
+
+void InitGame(void)
+{
+	InitFrameArena();
+	InitItemDatabase();
+	globalSceneStack = InitSceneStack();
+
+	PushScene(globalSceneStack, LoadScene(CreateBaseScene(&base_scene_context, &base_scene)));
+	PushScene(globalSceneStack, LoadScene(CreateTitleScreenScene(&title_screen_context, &title_scene)));
+	world = CreateEntityWorld(MAX_ENTITIES);
+	spatialHash = CreateSpatialHash(MAX_ENTITIES, SPATIAL_CELL_SIZE);
+	player = CreatePlayer(world, "character/player.anim", (Vector2) { 100, 350 });
+
+	playerData.character = (Character){ player.entity, { 0 }, characterName, 220, 60 };
+	InitInventory(&playerData.inv, INVENTORY_SLOTS);
+}
+
+void TickGame(void)
+{
+	SceneStack* stack = globalSceneStack;
+	if (stack->scene_count == 0)
+	{
+		DebugLog(LOG_ERROR, "GetCurrentScene(globalSceneStack) failed to return valid scene.");
+		return;
+	}
+
+	SaveEntityPositions(world);
+
+	unsigned int version = stack->version;
+	for (int i = stack->updateFrom; i <= stack->top; i++)
+	{
+		Scene* scene = stack->scenes[i];
+		double start = PlatformGetTime();
+		UpdateScene(scene);
+		RecordSceneUpdate(scene, PlatformGetTime() - start);
+		if (stack->version != version) break; // The stack changed, the new layers start ticking next step
+	}
+
+	PROFILE_BEGIN("ecs", "MoveEntities");
+	MoveEntities(world, GetSimulationDelta());
+	PROFILE_END();
+	PROFILE_BEGIN("ecs", "AnimateEntities");
+	AnimateEntities(world, GetSimulationDelta());
+	PROFILE_END();
+	PROFILE_BEGIN("ecs", "RebuildSpatialHash");
+	RebuildSpatialHash(spatialHash, world); // Scenes query it next tick and when rendering
+	PROFILE_END();
+	ConsumeInputPresses();
+}
+
+void RenderGame(void)
+{
+	SceneStack* stack = globalSceneStack;
+
+	// Scenes draw their backgrounds directly; HUD and characters are batched on top.
+	// Scenes interpolate between ticks themselves, with GetRenderAlpha().
+	BeginSpriteBatch();
+	for (int i = stack->renderFrom; i <= stack->top; i++)
+	{
+		RenderScene(stack->scenes[i]);
+	}
+	PROFILE_BEGIN("render", "EndSpriteBatch");
+	EndSpriteBatch();
+	PROFILE_END();
+}
+
+void ShutdownGame(void)
+{
+	// Free whatever is still on the stack, down to the persistent base
+	while (globalSceneStack->scene_count > 0 && !(GetCurrentScene(globalSceneStack)->flags & SCENE_PERSISTENT))
+	{
+		PopScene(globalSceneStack);
+	}
+	// Persistent scenes cannot be popped; they go with the stack
+	for (int i = globalSceneStack->top; i >= 0; i--)
+	{
+		FreeScene(globalSceneStack->scenes[i]);
+	}
+	GameFree(globalSceneStack);
+	globalSceneStack = NULL;
+	ShutdownText(); // After the scenes released their fonts
+	FreePlayer(&player);
+	FreeInventory(&playerData.inv);
+	DestroySpatialHash(spatialHash);
+	spatialHash = NULL;
+	DestroyEntityWorld(world);
+	world = NULL;
+	ShutdownFrameArena();
+}
+
+int GetGameWidth(void)
+{
+#if defined(CELISE_HEADLESS)
+	return GAME_WIDTH;
+#else
+	return GetScreenWidth();
+#endif
+}
+
+int GetGameHeight(void)
+{
+#if defined(CELISE_HEADLESS)
+	return GAME_HEIGHT;
+#else
+	return GetScreenHeight();
+#endif
+}
+
+EntityWorld* GetEntityWorld(void)
+{
+	return world;
+}
+
+SpatialHash* GetSpatialHash(void)
+{
+	return spatialHash;
+}
+
+Player* GetPlayer(void)
+{
+	return &player;
+}
+
+Player_2* GetPlayerData(void)
+{
+	return &playerData;
+}
+
+Attributes* GetPlayerAttributes(void)
+{
+	return &playerAttributes;
+}
+
+long long GetGameMinutes(void)
+{
+	return (long long)GetSimulationTime() + clockOffsetMinutes; // A game minute per simulated second
+}
+
+void SetGameMinutes(long long minutes)
+{
+	clockOffsetMinutes = minutes - (long long)GetSimulationTime();
+}
+
+int GetSceneUpdateTimings(const SceneUpdateTiming** timings)
+{
+	*timings = sceneTimings;
+	return SCENE_ID_COUNT;
+}
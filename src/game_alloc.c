@@ -0,0 +1,31 @@
+#include "game_alloc.h"
+#include "platform.h"
+#include <stdlib.h>
+
+static AllocStats allocStats = { 0 };
+
+void* GameAlloc(size_t size)
+{
+	PlatformAtomicAdd64(&allocStats.allocations, 1);
+	PlatformAtomicAdd64(&allocStats.bytesAllocated, size);
+	return malloc(size);
+}
+
+void* GameRealloc(void* ptr, size_t size)
+{
+	PlatformAtomicAdd64(&allocStats.allocations, 1);
+	PlatformAtomicAdd64(&allocStats.bytesAllocated, size);
+	return realloc(ptr, size);
+}
+
+void GameFree(void* ptr)
+{
+	if (!ptr) return;
+	PlatformAtomicAdd64(&allocStats.frees, 1);
+	free(ptr);
+}
+
+AllocStats GetAllocStats(void)
+{
+	return allocStats;
+}
@@ -0,0 +1,115 @@
+#include "hot_reload.h"
+#include "asset_cache.h"
+#include "layer_cache.h"
+#include "text.h"
+#include "platform.h"
+#include "profiler.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+	char path[MAX_ASSET_PATH];
+	double changedAt;
+} PendingChange;
+
+static PlatformWatcher* watcher = NULL;
+static PlatformThread* thread = NULL;
+static PlatformMutex* lock = NULL;
+static PendingChange pending[HOT_RELOAD_MAX_PENDING];
+static int pendingCount = 0;
+static int appliedReloads = 0;
+
+// Only records the change: a burst of writes to one file ends up as one reload
+static int WatcherMain(void* arg)
+{
+	(void)arg;
+	PROFILE_THREAD_NAME("file watcher");
+	char path[MAX_ASSET_PATH];
+	while (PlatformWaitForFileChange(watcher, path, sizeof(path)))
+	{
+		PlatformLockMutex(lock);
+		int i = 0;
+		while (i < pendingCount && strcmp(pending[i].path, path) != 0) i++;
+		if (i < HOT_RELOAD_MAX_PENDING)
+		{
+			if (i == pendingCount)
+			{
+				snprintf(pending[i].path, sizeof(pending[i].path), "%s", path);
+				pendingCount++;
+			}
+			pending[i].changedAt = PlatformGetTime();
+		}
+		PlatformUnlockMutex(lock);
+	}
+	return 0;
+}
+
+bool StartHotReload(const char* directory)
+{
+	if (thread) return true;
+	pendingCount = 0;
+	appliedReloads = GetAssetCacheStats().reloads;
+	watcher = PlatformWatchDirectory(directory);
+	lock = watcher ? PlatformCreateMutex() : NULL;
+	thread = lock ? PlatformCreateThread(WatcherMain, NULL) : NULL;
+	if (!thread)
+	{
+		DebugLog(LOG_WARNING, "Could not watch <%s>, hot reload is off", directory);
+		if (lock) PlatformDestroyMutex(lock);
+		PlatformCloseWatcher(watcher);
+		watcher = NULL;
+		lock = NULL;
+		return false;
+	}
+	DebugLog(LOG_INFO, "Hot reload: watching <%s>", directory);
+	return true;
+}
+
+void StopHotReload(void)
+{
+	if (!thread) return;
+	PlatformCancelWatch(watcher);
+	PlatformJoinThread(thread);
+	PlatformCloseWatcher(watcher);
+	PlatformDestroyMutex(lock);
+	thread = NULL;
+	watcher = NULL;
+	lock = NULL;
+}
+
+void PumpHotReload(void)
+{
+	if (!thread) return;
+
+	// Uploads applied by this frame's PumpAssetUploads(): redraw whatever was built from them
+	int reloads = GetAssetCacheStats().reloads;
+	if (reloads != appliedReloads)
+	{
+		appliedReloads = reloads;
+		InvalidateAllCachedLayers();
+		InvalidateTextLayouts();
+	}
+
+	PendingChange settled[HOT_RELOAD_MAX_PENDING];
+	int settledCount = 0;
+	double now = PlatformGetTime();
+	PlatformLockMutex(lock);
+	for (int i = 0; i < pendingCount; )
+	{
+		if ((now - pending[i].changedAt) * 1000.0 < HOT_RELOAD_SETTLE_MS)
+		{
+			i++;
+			continue;
+		}
+		settled[settledCount++] = pending[i];
+		pending[i] = pending[--pendingCount];
+	}
+	PlatformUnlockMutex(lock);
+
+	for (int i = 0; i < settledCount; i++)
+	{
+		int count = ReloadAssetFile(settled[i].path);
+		if (count > 0) DebugLog(LOG_INFO, "<%s> changed, reloading %d asset(s)", settled[i].path, count);
+	}
+}
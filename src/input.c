@@ -0,0 +1,285 @@
+#include "input.h"
+#include "logger.h"
+#include "platform.h"
+#include <string.h>
+
+#define INPUT_MAX_BINDINGS 2
+#define INPUT_MAX_IN_FLIGHT 64 // Events consumed by a tick, waiting for their frame to be presented
+#define FIRST_FRAME_ACTION ACTION_TOGGLE_FRAME_STATS
+
+static InputState input = { 0 };
+static double seenAt[ACTION_COUNT]; // When a sample first saw the pending press or hold, 0 when none
+static double inFlight[INPUT_MAX_IN_FLIGHT];
+static int inFlightCount = 0;
+static InputLatencyStats latency = { 0 };
+
+// New presses and holds get the time of the sample that first saw them
+static void TimestampEvents(const bool* wasDown)
+{
+	double now = PlatformGetTime();
+	for (int action = 0; action < ACTION_COUNT; action++)
+	{
+		bool started = input.pressed[action] || (input.down[action] && !wasDown[action]);
+		if (started && seenAt[action] == 0.0) seenAt[action] = now;
+	}
+}
+
+static void MarkInFlight(InputAction action)
+{
+	if (seenAt[action] == 0.0) return;
+	if (inFlightCount < INPUT_MAX_IN_FLIGHT) inFlight[inFlightCount++] = seenAt[action];
+	seenAt[action] = 0.0;
+}
+
+#if defined(CELISE_HEADLESS)
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_SCRIPT_EVENTS 256
+
+typedef enum
+{
+	SCRIPT_LEFT,
+	SCRIPT_RIGHT,
+	SCRIPT_RUN,
+	SCRIPT_ANY,
+	SCRIPT_CONFIRM,
+	SCRIPT_DOWN,
+	SCRIPT_CLICK,
+	SCRIPT_POINTER
+} ScriptAction;
+
+typedef struct {
+	long long start;
+	long long end;
+	ScriptAction action;
+	Vector2 pointer;
+} ScriptEvent;
+
+static const char* scriptActionNames[] = { "left", "right", "run", "any", "confirm", "down", "click", "pointer" };
+
+static ScriptEvent script[MAX_SCRIPT_EVENTS];
+static int scriptCount = 0;
+static long long scriptTick = 0;
+
+static bool ParseScriptLine(const char* line, ScriptEvent* event)
+{
+	char name[16] = { 0 };
+	event->pointer = (Vector2){ 0, 0 };
+	if (sscanf(line, "%lld-%lld %15s %f %f", &event->start, &event->end, name, &event->pointer.x, &event->pointer.y) < 3)
+	{
+		if (sscanf(line, "%lld %15s %f %f", &event->start, name, &event->pointer.x, &event->pointer.y) < 2)
+		{
+			return false;
+		}
+		event->end = event->start;
+	}
+
+	for (int i = 0; i < (int)(sizeof(scriptActionNames) / sizeof(scriptActionNames[0])); i++)
+	{
+		if (strcmp(name, scriptActionNames[i]) == 0)
+		{
+			event->action = (ScriptAction)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void SetInputScript(const char* text)
+{
+	scriptCount = 0;
+	scriptTick = 0;
+	input = (InputState){ 0 };
+
+	int lineNumber = 0;
+	while (text && *text)
+	{
+		char line[128] = { 0 };
+		int length = (int)strcspn(text, "\r\n");
+		snprintf(line, sizeof(line), "%.*s", length, text);
+		text += length;
+		text += strspn(text, "\r\n");
+		lineNumber++;
+
+		const char* start = line + strspn(line, " \t");
+		if (*start == '#' || *start == '\0') continue;
+
+		if (scriptCount == MAX_SCRIPT_EVENTS)
+		{
+			DebugLog(LOG_WARNING, "Input script has more than %d events, ignoring the rest", MAX_SCRIPT_EVENTS);
+			return;
+		}
+		if (ParseScriptLine(start, &script[scriptCount]))
+		{
+			scriptCount++;
+		}
+		else
+		{
+			DebugLog(LOG_WARNING, "Input script line %d not understood: %s", lineNumber, start);
+		}
+	}
+}
+
+bool LoadInputScript(const char* path)
+{
+	char* text = LoadFileText(path);
+	if (!text) return false;
+	SetInputScript(text);
+	UnloadFileText(text);
+	return true;
+}
+
+void SampleInput(void)
+{
+	bool wasDown[ACTION_COUNT];
+	memcpy(wasDown, input.down, sizeof(wasDown));
+	memset(input.down, 0, sizeof(input.down));
+
+	for (int i = 0; i < scriptCount; i++)
+	{
+		ScriptEvent* event = &script[i];
+		if (scriptTick < event->start || scriptTick > event->end) continue;
+
+		bool first = scriptTick == event->start;
+		switch (event->action)
+		{
+		case SCRIPT_LEFT: input.down[ACTION_MOVE_LEFT] = true; break;
+		case SCRIPT_RIGHT: input.down[ACTION_MOVE_RIGHT] = true; break;
+		case SCRIPT_RUN: input.down[ACTION_RUN] = true; break;
+		case SCRIPT_ANY: input.anyKey |= first; break;
+		case SCRIPT_CONFIRM: input.pressed[ACTION_CONFIRM] |= first; input.anyKey |= first; break;
+		case SCRIPT_DOWN: input.pressed[ACTION_NAV_DOWN] |= first; input.anyKey |= first; break;
+		case SCRIPT_CLICK: input.pressed[ACTION_CLICK] |= first; break;
+		case SCRIPT_POINTER: input.pointer = event->pointer; break;
+		}
+	}
+	scriptTick++;
+	TimestampEvents(wasDown);
+}
+
+// Scripts have nothing to poll, each sample is one scripted tick
+void LatchInput(void)
+{
+	SampleInput();
+}
+
+#else
+
+typedef enum
+{
+	BINDING_NONE,
+	BINDING_KEY,
+	BINDING_MOUSE_BUTTON
+} BindingDevice;
+
+typedef struct {
+	BindingDevice device;
+	int code;
+} InputBinding;
+
+static const InputBinding bindings[ACTION_COUNT][INPUT_MAX_BINDINGS] = {
+	[ACTION_MOVE_LEFT] = { { BINDING_KEY, KEY_LEFT } },
+	[ACTION_MOVE_RIGHT] = { { BINDING_KEY, KEY_RIGHT } },
+	[ACTION_RUN] = { { BINDING_KEY, KEY_LEFT_SHIFT } },
+	[ACTION_CONFIRM] = { { BINDING_KEY, KEY_ENTER } },
+	[ACTION_NAV_DOWN] = { { BINDING_KEY, KEY_DOWN } },
+	[ACTION_CLICK] = { { BINDING_MOUSE_BUTTON, MOUSE_LEFT_BUTTON } },
+	[ACTION_TOGGLE_FRAME_STATS] = { { BINDING_KEY, KEY_F1 } },
+	[ACTION_TOGGLE_PROFILER] = { { BINDING_KEY, KEY_F2 } },
+	[ACTION_EXPORT_TRACE] = { { BINDING_KEY, KEY_F3 } },
+	[ACTION_CYCLE_DRAW_VIEW] = { { BINDING_KEY, KEY_F4 } },
+	[ACTION_QUICKSAVE] = { { BINDING_KEY, KEY_F5 } },
+	[ACTION_QUICKLOAD] = { { BINDING_KEY, KEY_F9 } },
+};
+
+void SampleInput(void)
+{
+	bool wasDown[ACTION_COUNT];
+	memcpy(wasDown, input.down, sizeof(wasDown));
+
+	for (int action = 0; action < ACTION_COUNT; action++)
+	{
+		bool down = false;
+		bool pressed = false;
+		for (int i = 0; i < INPUT_MAX_BINDINGS; i++)
+		{
+			const InputBinding* binding = &bindings[action][i];
+			if (binding->device == BINDING_KEY)
+			{
+				down |= IsKeyDown(binding->code);
+				pressed |= IsKeyPressed(binding->code);
+			}
+			else if (binding->device == BINDING_MOUSE_BUTTON)
+			{
+				down |= IsMouseButtonDown(binding->code);
+				pressed |= IsMouseButtonPressed(binding->code);
+			}
+		}
+		input.down[action] = down;
+		input.pressed[action] |= pressed;
+	}
+	input.pointer = GetMousePosition();
+
+	// Drain the whole queue so stale presses never leak into a later frame
+	while (GetKeyPressed() != 0)
+	{
+		input.anyKey = true;
+	}
+	TimestampEvents(wasDown);
+}
+
+// raylib polls once per frame, in EndDrawing() before the frame limiter wait. Without a
+// second poll, whatever arrives during that wait, the bookkeeping after EndDrawing() and
+// the start of the next frame reaches the simulation a frame late. Presses from the
+// first poll were already latched by the SampleInput() after EndDrawing().
+void LatchInput(void)
+{
+	PollInputEvents();
+	SampleInput();
+}
+
+#endif
+
+void ConsumeInputPresses(void)
+{
+	for (int action = 0; action < FIRST_FRAME_ACTION; action++)
+	{
+		input.pressed[action] = false;
+		MarkInFlight((InputAction)action);
+	}
+	input.anyKey = false;
+}
+
+bool TakeFramePress(InputAction action)
+{
+	bool pressed = input.pressed[action];
+	input.pressed[action] = false;
+	if (pressed) MarkInFlight(action);
+	return pressed;
+}
+
+void NoteFramePresented(void)
+{
+	double now = PlatformGetTime();
+	for (int i = 0; i < inFlightCount; i++)
+	{
+		double ms = (now - inFlight[i]) * 1000.0;
+		latency.averageMs = latency.events == 0 ? ms : latency.averageMs + (ms - latency.averageMs) * 0.05;
+		latency.lastMs = ms;
+		if (ms > latency.worstMs) latency.worstMs = ms;
+		latency.events++;
+	}
+	inFlightCount = 0;
+}
+
+InputLatencyStats GetInputLatencyStats(void)
+{
+	return latency;
+}
+
+const InputState* GetInput(void)
+{
+	return &input;
+}
@@ -0,0 +1,265 @@
+#include "inventory.h"
+#include "game_alloc.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ------ Index ------
+
+// Ids are small and dense, so the id itself spreads well enough
+static unsigned int HomeOf(const Inventory* inventory, ItemId item)
+{
+	return item & inventory->indexMask;
+}
+
+static InventoryIndexEntry* FindEntry(const Inventory* inventory, ItemId item)
+{
+	if (!inventory->index) return NULL;
+	for (unsigned int i = HomeOf(inventory, item); inventory->index[i].item != ITEM_NONE; i = (i + 1) & inventory->indexMask)
+	{
+		if (inventory->index[i].item == item) return &inventory->index[i];
+	}
+	return NULL;
+}
+
+static InventoryIndexEntry* InsertEntry(Inventory* inventory, ItemId item)
+{
+	unsigned int i = HomeOf(inventory, item);
+	while (inventory->index[i].item != ITEM_NONE) i = (i + 1) & inventory->indexMask;
+	inventory->index[i] = (InventoryIndexEntry){ item, 0, 0, -1 };
+	return &inventory->index[i];
+}
+
+// Backward shift, so lookups never need tombstones
+static void DeleteEntry(Inventory* inventory, InventoryIndexEntry* entry)
+{
+	unsigned int mask = inventory->indexMask;
+	unsigned int hole = (unsigned int)(entry - inventory->index);
+	for (unsigned int i = (hole + 1) & mask; inventory->index[i].item != ITEM_NONE; i = (i + 1) & mask)
+	{
+		unsigned int home = HomeOf(inventory, inventory->index[i].item);
+		if (((i - home) & mask) >= ((i - hole) & mask))
+		{
+			inventory->index[hole] = inventory->index[i];
+			hole = i;
+		}
+	}
+	inventory->index[hole].item = ITEM_NONE;
+}
+
+// ------ Slots ------
+
+static int TakeFreeSlot(Inventory* inventory)
+{
+	int slot = inventory->freeHead;
+	if (slot >= 0)
+	{
+		inventory->freeHead = inventory->links[slot];
+		inventory->usedSlots++;
+	}
+	return slot;
+}
+
+static void ReleaseSlot(Inventory* inventory, int slot)
+{
+	inventory->slots[slot] = (InventorySlot){ ITEM_NONE, 0 };
+	inventory->links[slot] = inventory->freeHead;
+	inventory->freeHead = slot;
+	inventory->usedSlots--;
+}
+
+// Lowest slots are handed out first
+static void ResetFreeList(Inventory* inventory)
+{
+	inventory->freeHead = -1;
+	for (int slot = inventory->capacity - 1; slot >= 0; slot--)
+	{
+		if (inventory->slots[slot].item != ITEM_NONE) continue;
+		inventory->links[slot] = inventory->freeHead;
+		inventory->freeHead = slot;
+	}
+}
+
+bool InitInventory(Inventory* inventory, int capacity)
+{
+	*inventory = (Inventory){ 0 };
+	inventory->freeHead = -1;
+	if (capacity <= 0 || capacity > INVENTORY_MAX_CAPACITY) return false;
+
+	// Every distinct item needs a slot, so the index is at most half full
+	unsigned int indexCapacity = 16;
+	while (indexCapacity < (unsigned int)capacity * 2) indexCapacity *= 2;
+
+	size_t keyBytes = sizeof(unsigned long long) * capacity;
+	size_t indexBytes = sizeof(InventoryIndexEntry) * indexCapacity;
+	size_t linkBytes = sizeof(int) * capacity;
+	unsigned char* block = (unsigned char*)GameAlloc(keyBytes + indexBytes + linkBytes + sizeof(InventorySlot) * capacity);
+	if (!block) return false;
+
+	inventory->sortKeys = (unsigned long long*)block;
+	inventory->index = (InventoryIndexEntry*)(block + keyBytes);
+	inventory->links = (int*)(block + keyBytes + indexBytes);
+	inventory->slots = (InventorySlot*)(block + keyBytes + indexBytes + linkBytes);
+	inventory->capacity = capacity;
+	inventory->indexMask = indexCapacity - 1;
+	ClearInventory(inventory);
+	return true;
+}
+
+void FreeInventory(Inventory* inventory)
+{
+	GameFree(inventory->sortKeys); // Start of the block
+	*inventory = (Inventory){ 0 };
+	inventory->freeHead = -1;
+}
+
+void ClearInventory(Inventory* inventory)
+{
+	if (!inventory->slots) return;
+	memset(inventory->slots, 0, sizeof(InventorySlot) * inventory->capacity);
+	memset(inventory->index, 0, sizeof(InventoryIndexEntry) * (inventory->indexMask + 1));
+	inventory->usedSlots = 0;
+	ResetFreeList(inventory);
+}
+
+bool RebuildInventory(Inventory* inventory)
+{
+	if (!inventory->slots) return false;
+	memset(inventory->index, 0, sizeof(InventoryIndexEntry) * (inventory->indexMask + 1));
+	inventory->usedSlots = 0;
+
+	for (int slot = 0; slot < inventory->capacity; slot++)
+	{
+		InventorySlot* stack = &inventory->slots[slot];
+		if (stack->item == ITEM_NONE) continue;
+		const ItemRecord* record = GetItemRecord(stack->item);
+		if (!record || stack->count == 0 || stack->count > record->maxStack)
+		{
+			ClearInventory(inventory);
+			return false;
+		}
+
+		InventoryIndexEntry* entry = FindEntry(inventory, stack->item);
+		if (!entry) entry = InsertEntry(inventory, stack->item);
+		bool partial = stack->count < record->maxStack;
+		bool headPartial = entry->head >= 0 && inventory->slots[entry->head].count < record->maxStack;
+		if (partial && headPartial)
+		{
+			ClearInventory(inventory);
+			return false;
+		}
+		if (headPartial)
+		{
+			// Full stacks go behind the partial one
+			inventory->links[slot] = inventory->links[entry->head];
+			inventory->links[entry->head] = slot;
+		}
+		else
+		{
+			inventory->links[slot] = entry->head;
+			entry->head = slot;
+		}
+		entry->total += stack->count;
+		inventory->usedSlots++;
+	}
+	ResetFreeList(inventory);
+	return true;
+}
+
+// ------ Queries ------
+
+int AddItems(Inventory* inventory, ItemId item, int count)
+{
+	const ItemRecord* record = GetItemRecord(item);
+	if (!record || count <= 0 || !inventory->slots) return count;
+
+	InventoryIndexEntry* entry = FindEntry(inventory, item);
+	if (!entry)
+	{
+		if (inventory->freeHead < 0) return count;
+		entry = InsertEntry(inventory, item);
+	}
+
+	int remaining = count;
+	if (entry->head >= 0)
+	{
+		InventorySlot* head = &inventory->slots[entry->head];
+		int room = record->maxStack - head->count;
+		int added = remaining < room ? remaining : room;
+		head->count += (unsigned short)added;
+		remaining -= added;
+	}
+	// Each new stack becomes the head, and only the last one can be partial
+	while (remaining > 0)
+	{
+		int slot = TakeFreeSlot(inventory);
+		if (slot < 0) break;
+		int added = remaining < record->maxStack ? remaining : record->maxStack;
+		inventory->slots[slot] = (InventorySlot){ item, (unsigned short)added };
+		inventory->links[slot] = entry->head;
+		entry->head = slot;
+		remaining -= added;
+	}
+	entry->total += count - remaining;
+	return remaining;
+}
+
+int RemoveItems(Inventory* inventory, ItemId item, int count)
+{
+	InventoryIndexEntry* entry = FindEntry(inventory, item);
+	if (!entry || count <= 0) return 0;
+
+	int removed = count < entry->total ? count : entry->total;
+	int remaining = removed;
+	while (remaining > 0)
+	{
+		int slot = entry->head;
+		InventorySlot* head = &inventory->slots[slot];
+		int taken = remaining < head->count ? remaining : head->count;
+		head->count -= (unsigned short)taken;
+		remaining -= taken;
+		if (head->count == 0)
+		{
+			entry->head = inventory->links[slot];
+			ReleaseSlot(inventory, slot);
+		}
+	}
+	entry->total -= removed;
+	if (entry->total == 0) DeleteEntry(inventory, entry);
+	return removed;
+}
+
+int CountItem(const Inventory* inventory, ItemId item)
+{
+	const InventoryIndexEntry* entry = FindEntry(inventory, item);
+	return entry ? entry->total : 0;
+}
+
+bool HasItem(const Inventory* inventory, ItemId item)
+{
+	return FindEntry(inventory, item) != NULL;
+}
+
+// ------ Sorting ------
+
+static int CompareSortKeys(const void* a, const void* b)
+{
+	unsigned long long x = *(const unsigned long long*)a;
+	unsigned long long y = *(const unsigned long long*)b;
+	return (x > y) - (x < y);
+}
+
+int GetSortedInventorySlots(Inventory* inventory, int* order)
+{
+	// Item sort key, then the stack size inverted, then the slot: one integer compare
+	int count = 0;
+	for (int slot = 0; slot < inventory->capacity; slot++)
+	{
+		const InventorySlot* stack = &inventory->slots[slot];
+		if (stack->item == ITEM_NONE) continue;
+		inventory->sortKeys[count++] = ((unsigned long long)GetItemRecord(stack->item)->sortKey << 32) |
+			((unsigned long long)(0xFFFFu - stack->count) << 16) | (unsigned long long)slot;
+	}
+	qsort(inventory->sortKeys, count, sizeof(unsigned long long), CompareSortKeys);
+	for (int i = 0; i < count; i++) order[i] = (int)(inventory->sortKeys[i] & 0xFFFFu);
+	return count;
+}
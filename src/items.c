@@ -0,0 +1,129 @@
+#include "items.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ITEM_HASH_SIZE (MAX_ITEMS * 2) // Power of two
+
+static const ItemDef itemDefs[] = {
+	{ "castle_key", "Castle key", ITEM_CATEGORY_KEY, 1, 0 },
+	{ "cellar_key", "Cellar key", ITEM_CATEGORY_KEY, 1, 0 },
+	{ "iron_key", "Iron key", ITEM_CATEGORY_KEY, 1, 0 },
+	{ "dagger", "Dagger", ITEM_CATEGORY_WEAPON, 1, 40 },
+	{ "short_sword", "Short sword", ITEM_CATEGORY_WEAPON, 1, 120 },
+	{ "bread", "Bread", ITEM_CATEGORY_CONSUMABLE, 20, 2 },
+	{ "apple", "Apple", ITEM_CATEGORY_CONSUMABLE, 20, 1 },
+	{ "cheese", "Cheese", ITEM_CATEGORY_CONSUMABLE, 10, 4 },
+	{ "healing_draught", "Healing draught", ITEM_CATEGORY_CONSUMABLE, 5, 25 },
+	{ "mana_tonic", "Mana tonic", ITEM_CATEGORY_CONSUMABLE, 5, 30 },
+	{ "sealed_letter", "Sealed letter", ITEM_CATEGORY_DOCUMENT, 1, 0 },
+	{ "royal_decree", "Royal decree", ITEM_CATEGORY_DOCUMENT, 1, 0 },
+	{ "map_fragment", "Map fragment", ITEM_CATEGORY_DOCUMENT, 8, 15 },
+	{ "candle", "Candle", ITEM_CATEGORY_TOOL, 10, 1 },
+	{ "rope", "Rope", ITEM_CATEGORY_TOOL, 5, 3 },
+	{ "lockpick", "Lockpick", ITEM_CATEGORY_TOOL, 25, 5 },
+	{ "herbs", "Herbs", ITEM_CATEGORY_MATERIAL, 50, 1 },
+	{ "iron_ore", "Iron ore", ITEM_CATEGORY_MATERIAL, 50, 3 },
+	{ "silver_ingot", "Silver ingot", ITEM_CATEGORY_MATERIAL, 20, 18 },
+	{ "gold_ring", "Gold ring", ITEM_CATEGORY_TREASURE, 10, 75 },
+	{ "ruby", "Ruby", ITEM_CATEGORY_TREASURE, 10, 150 },
+};
+
+// Index 0 is ITEM_NONE
+static ItemRecord records[MAX_ITEMS + 1];
+static const ItemDef* defs[MAX_ITEMS + 1];
+static int itemCount = 0;
+static ItemId keyHash[ITEM_HASH_SIZE]; // Open addressing over the keys, ITEM_NONE when empty
+
+static unsigned int HashKey(const char* key)
+{
+	unsigned int hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)key; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static int CompareItemNames(const void* a, const void* b)
+{
+	return strcmp(defs[*(const ItemId*)a]->name, defs[*(const ItemId*)b]->name);
+}
+
+void InitItemDatabase(void)
+{
+	memset(keyHash, 0, sizeof(keyHash));
+	itemCount = 0;
+
+	int count = (int)(sizeof(itemDefs) / sizeof(itemDefs[0]));
+	for (int i = 0; i < count && itemCount < MAX_ITEMS; i++)
+	{
+		const ItemDef* def = &itemDefs[i];
+		if (FindItem(def->key) != ITEM_NONE)
+		{
+			DebugLog(LOG_WARNING, "Item <%s> is defined twice, keeping the first", def->key);
+			continue;
+		}
+
+		ItemId id = (ItemId)++itemCount;
+		defs[id] = def;
+		records[id] = (ItemRecord){ 0, def->value, (unsigned short)(def->maxStack > 0 ? def->maxStack : 1), (unsigned char)def->category, 0 };
+
+		unsigned int slot = HashKey(def->key) & (ITEM_HASH_SIZE - 1);
+		while (keyHash[slot] != ITEM_NONE) slot = (slot + 1) & (ITEM_HASH_SIZE - 1);
+		keyHash[slot] = id;
+	}
+
+	// Sort keys: category in the top byte, the rank of the name in the rest
+	ItemId byName[MAX_ITEMS];
+	for (int i = 0; i < itemCount; i++) byName[i] = (ItemId)(i + 1);
+	qsort(byName, itemCount, sizeof(ItemId), CompareItemNames);
+	for (int rank = 0; rank < itemCount; rank++)
+	{
+		ItemRecord* record = &records[byName[rank]];
+		record->sortKey = ((unsigned int)record->category << 24) | (unsigned int)rank;
+	}
+
+	DebugLog(LOG_INFO, "Item database: %d items", itemCount);
+}
+
+int GetItemCount(void)
+{
+	return itemCount;
+}
+
+ItemId FindItem(const char* key)
+{
+	unsigned int slot = HashKey(key) & (ITEM_HASH_SIZE - 1);
+	while (keyHash[slot] != ITEM_NONE)
+	{
+		if (strcmp(defs[keyHash[slot]]->key, key) == 0) return keyHash[slot];
+		slot = (slot + 1) & (ITEM_HASH_SIZE - 1);
+	}
+	return ITEM_NONE;
+}
+
+ItemId FindItemByName(const char* name)
+{
+	for (int id = 1; id <= itemCount; id++)
+	{
+		if (strcmp(defs[id]->name, name) == 0) return (ItemId)id;
+	}
+	return ITEM_NONE;
+}
+
+const ItemRecord* GetItemRecord(ItemId item)
+{
+	return item != ITEM_NONE && item <= itemCount ? &records[item] : NULL;
+}
+
+const char* GetItemKey(ItemId item)
+{
+	return item != ITEM_NONE && item <= itemCount ? defs[item]->key : NULL;
+}
+
+const char* GetItemName(ItemId item)
+{
+	return item != ITEM_NONE && item <= itemCount ? defs[item]->name : NULL;
+}
@@ -0,0 +1,374 @@
+#include "jobs.h"
+#include "platform.h"
+#include "profiler.h"
+#include "logger.h"
+#include <stddef.h>
+
+#if defined(_MSC_VER)
+#define JOB_THREAD_LOCAL __declspec(thread)
+#else
+#define JOB_THREAD_LOCAL _Thread_local
+#endif
+
+#define JOB_MAX_THREADS (JOB_MAX_WORKERS + 1)
+#define JOB_SPINS_BEFORE_SLEEP 64
+#define JOB_MAX_RANGES (JOB_QUEUE_SIZE / 2) // Per ParallelFor, so a call never fills the deque on its own
+
+struct Job {
+	JobFunc func;
+	void* data;
+	int begin;
+	int end;
+	JobCounter* counter;
+	Job* next; // In a counter's waiters
+};
+
+// Chase-Lev deque, fixed size. The owner pushes and pops at bottom; thieves take from
+// top with a CAS, and the owner only races them for the last job.
+typedef struct {
+	volatile long long top;
+	char topPadding[64 - sizeof(long long)]; // Thieves hammer top, keep bottom off its cache line
+	volatile long long bottom;
+	char bottomPadding[64 - sizeof(long long)];
+	Job* volatile jobs[JOB_QUEUE_SIZE];
+} JobQueue;
+
+typedef struct {
+	JobQueue queue;
+	Job pool[JOB_POOL_SIZE];
+	unsigned int poolNext;
+	unsigned int random; // Picks steal victims
+	PlatformThread* thread;
+} JobThread;
+
+static JobThread threads[JOB_MAX_THREADS];
+static int threadCount = 0; // Deques in use, fixed before any worker starts
+static int workerCount = 0; // Started, main thread only
+static bool running = false;
+static volatile long long queuedJobs = 0; // In some deque, not taken yet
+static volatile long long sleepers = 0;
+static volatile long long quit = 0;
+static PlatformMutex* lock = NULL;
+static PlatformCond* workAvailable = NULL;
+static JOB_THREAD_LOCAL int threadSlot = 0; // Index + 1, 0 for threads that do not own a deque
+
+static const char* workerNames[JOB_MAX_WORKERS] = {
+	"job worker 1", "job worker 2", "job worker 3", "job worker 4", "job worker 5",
+	"job worker 6", "job worker 7", "job worker 8", "job worker 9", "job worker 10",
+	"job worker 11", "job worker 12", "job worker 13", "job worker 14", "job worker 15"
+};
+
+// ------ Deque ------
+
+static bool PushQueue(JobQueue* queue, Job* job)
+{
+	long long bottom = queue->bottom;
+	long long top = PlatformAtomicLoad64(&queue->top);
+	if (bottom - top >= JOB_QUEUE_SIZE) return false;
+	queue->jobs[bottom & (JOB_QUEUE_SIZE - 1)] = job;
+	PlatformAtomicStore64(&queue->bottom, bottom + 1);
+	return true;
+}
+
+static Job* PopQueue(JobQueue* queue)
+{
+	long long bottom = queue->bottom - 1;
+	PlatformAtomicStore64(&queue->bottom, bottom);
+	PlatformAtomicFence(); // The store above must be visible before top is read
+	long long top = PlatformAtomicLoad64(&queue->top);
+	if (top > bottom)
+	{
+		PlatformAtomicStore64(&queue->bottom, bottom + 1);
+		return NULL;
+	}
+
+	Job* job = queue->jobs[bottom & (JOB_QUEUE_SIZE - 1)];
+	if (top == bottom)
+	{
+		// Last job: whoever moves top first gets it
+		if (!PlatformAtomicCas64(&queue->top, top, top + 1)) job = NULL;
+		PlatformAtomicStore64(&queue->bottom, bottom + 1);
+	}
+	return job;
+}
+
+static Job* StealQueue(JobQueue* queue)
+{
+	long long top = PlatformAtomicLoad64(&queue->top);
+	PlatformAtomicFence();
+	long long bottom = PlatformAtomicLoad64(&queue->bottom);
+	if (top >= bottom) return NULL;
+
+	Job* job = queue->jobs[top & (JOB_QUEUE_SIZE - 1)];
+	return PlatformAtomicCas64(&queue->top, top, top + 1) ? job : NULL;
+}
+
+// ------ Scheduling ------
+
+static JobThread* CurrentThread(void)
+{
+	return running && threadSlot > 0 ? &threads[threadSlot - 1] : NULL;
+}
+
+static void LockCounter(JobCounter* counter)
+{
+	while (!PlatformAtomicCas64(&counter->lock, 0, 1)) {}
+}
+
+static void UnlockCounter(JobCounter* counter)
+{
+	PlatformAtomicStore64(&counter->lock, 0);
+}
+
+static void ExecuteJob(Job* job);
+
+static void PushJob(Job* job)
+{
+	JobThread* self = CurrentThread();
+	if (!self || threadCount < 2 || !PushQueue(&self->queue, job))
+	{
+		ExecuteJob(job); // No deque, or it is full
+		return;
+	}
+
+	PlatformAtomicAdd64(&queuedJobs, 1);
+	PlatformAtomicFence(); // Pairs with the one in WorkerMain, so a worker going to sleep sees the job
+	if (PlatformAtomicLoad64(&sleepers) > 0)
+	{
+		PlatformLockMutex(lock);
+		PlatformSignalCond(workAvailable);
+		PlatformUnlockMutex(lock);
+	}
+}
+
+// The count drops under the lock, and AreJobsDone() also waits for the lock: counters
+// often live on the waiter's stack, which must not be touched once it has returned
+static void FinishCounter(JobCounter* counter)
+{
+	Job* waiter = NULL;
+	LockCounter(counter);
+	if (PlatformAtomicAdd64(&counter->pending, -1) == 1)
+	{
+		waiter = counter->waiters;
+		counter->waiters = NULL;
+	}
+	UnlockCounter(counter);
+	while (waiter)
+	{
+		Job* next = waiter->next;
+		PushJob(waiter);
+		waiter = next;
+	}
+}
+
+static void ExecuteJob(Job* job)
+{
+	Job run = *job; // The slot may be handed out again while func runs
+	PROFILE_BEGIN("jobs", "job");
+	run.func(run.data, run.begin, run.end);
+	PROFILE_END();
+	if (run.counter) FinishCounter(run.counter);
+}
+
+static Job* FindJob(JobThread* self)
+{
+	Job* job = self ? PopQueue(&self->queue) : NULL;
+	if (!job)
+	{
+		// Start at a random victim so thieves spread out
+		unsigned int random = self ? self->random : 0;
+		random ^= random << 13;
+		random ^= random >> 17;
+		random ^= random << 5;
+		if (self) self->random = random;
+		for (int i = 0; i < threadCount && !job; i++)
+		{
+			JobThread* victim = &threads[(random + i) % threadCount];
+			if (victim != self) job = StealQueue(&victim->queue);
+		}
+	}
+	if (job) PlatformAtomicAdd64(&queuedJobs, -1);
+	return job;
+}
+
+static Job* AllocJob(JobFunc func, void* data, int begin, int end, JobCounter* counter)
+{
+	static JOB_THREAD_LOCAL Job inlineJob; // Threads without a pool run their jobs right away
+	JobThread* self = CurrentThread();
+	Job* job = self ? &self->pool[self->poolNext++ & (JOB_POOL_SIZE - 1)] : &inlineJob;
+	*job = (Job){ func, data, begin, end, counter, NULL };
+	if (counter) PlatformAtomicAdd64(&counter->pending, 1);
+	return job;
+}
+
+static int WorkerMain(void* arg)
+{
+	threadSlot = (int)(ptrdiff_t)arg;
+	JobThread* self = &threads[threadSlot - 1];
+	PROFILE_THREAD_NAME(workerNames[threadSlot - 2]);
+
+	int idle = 0;
+	while (!PlatformAtomicLoad64(&quit))
+	{
+		Job* job = FindJob(self);
+		if (job)
+		{
+			ExecuteJob(job);
+			idle = 0;
+			continue;
+		}
+		if (++idle < JOB_SPINS_BEFORE_SLEEP) continue;
+
+		PlatformLockMutex(lock);
+		PlatformAtomicAdd64(&sleepers, 1);
+		PlatformAtomicFence();
+		while (!PlatformAtomicLoad64(&quit) && PlatformAtomicLoad64(&queuedJobs) == 0)
+		{
+			PlatformWaitCond(workAvailable, lock);
+		}
+		PlatformAtomicAdd64(&sleepers, -1);
+		PlatformUnlockMutex(lock);
+		idle = 0;
+	}
+	return 0;
+}
+
+// ------ API ------
+
+void InitJobSystem(int requestedWorkers)
+{
+	if (running) return;
+	if (requestedWorkers <= 0) requestedWorkers = PlatformGetCpuCount() - 1;
+	if (requestedWorkers > JOB_MAX_WORKERS) requestedWorkers = JOB_MAX_WORKERS;
+
+	lock = PlatformCreateMutex();
+	workAvailable = PlatformCreateCond();
+	quit = 0;
+	queuedJobs = 0;
+	sleepers = 0;
+	for (int i = 0; i < JOB_MAX_THREADS; i++)
+	{
+		threads[i].queue.top = 0;
+		threads[i].queue.bottom = 0;
+		threads[i].poolNext = 0;
+		threads[i].random = 2463534242u + (unsigned int)i * 7919u;
+		threads[i].thread = NULL;
+	}
+	threadSlot = 1;
+	running = true;
+
+	// A worker that fails to start leaves an empty deque behind, which costs thieves a look
+	threadCount = lock && workAvailable ? requestedWorkers + 1 : 1;
+	workerCount = 0;
+	for (int i = 1; i < threadCount; i++)
+	{
+		threads[i].thread = PlatformCreateThread(WorkerMain, (void*)(ptrdiff_t)(i + 1));
+		if (!threads[i].thread)
+		{
+			DebugLog(LOG_WARNING, "Could not start job worker %d", i);
+			continue;
+		}
+		workerCount++;
+	}
+	DebugLog(LOG_INFO, "Job system: %d workers", workerCount);
+}
+
+void ShutdownJobSystem(void)
+{
+	if (!running) return;
+	if (lock && workAvailable)
+	{
+		PlatformLockMutex(lock);
+		PlatformAtomicStore64(&quit, 1);
+		PlatformBroadcastCond(workAvailable);
+		PlatformUnlockMutex(lock);
+	}
+	for (int i = 1; i < threadCount; i++)
+	{
+		if (threads[i].thread) PlatformJoinThread(threads[i].thread);
+	}
+
+	if (workAvailable) PlatformDestroyCond(workAvailable);
+	if (lock) PlatformDestroyMutex(lock);
+	workAvailable = NULL;
+	lock = NULL;
+	workerCount = 0;
+	threadCount = 0;
+	running = false;
+	threadSlot = 0;
+}
+
+int GetJobWorkerCount(void)
+{
+	return workerCount;
+}
+
+void RunJob(JobFunc func, void* data, JobCounter* counter)
+{
+	PushJob(AllocJob(func, data, 0, 1, counter));
+}
+
+void RunJobAfter(JobFunc func, void* data, JobCounter* counter, JobCounter* dependency)
+{
+	if (!CurrentThread())
+	{
+		// Nowhere to park the job, so wait here
+		WaitForJobs(dependency);
+		RunJob(func, data, counter);
+		return;
+	}
+
+	Job* job = AllocJob(func, data, 0, 1, counter);
+	LockCounter(dependency);
+	if (PlatformAtomicLoad64(&dependency->pending) > 0)
+	{
+		job->next = dependency->waiters;
+		dependency->waiters = job;
+		job = NULL;
+	}
+	UnlockCounter(dependency);
+	if (job) PushJob(job);
+}
+
+bool AreJobsDone(const JobCounter* counter)
+{
+	return PlatformAtomicLoad64((volatile long long*)&counter->pending) == 0 &&
+		PlatformAtomicLoad64((volatile long long*)&counter->lock) == 0;
+}
+
+void WaitForJobs(JobCounter* counter)
+{
+	JobThread* self = CurrentThread();
+	while (!AreJobsDone(counter))
+	{
+		Job* job = FindJob(self);
+		if (job) ExecuteJob(job);
+		else PlatformSleep(0.0);
+	}
+}
+
+void ParallelFor(JobFunc func, void* data, int count, int grain)
+{
+	if (count <= 0) return;
+	if (grain < 1) grain = 1;
+	int ranges = (count + grain - 1) / grain;
+	if (ranges > JOB_MAX_RANGES)
+	{
+		ranges = JOB_MAX_RANGES;
+		grain = (count + ranges - 1) / ranges;
+	}
+	if (ranges == 1 || threadCount < 2 || !CurrentThread())
+	{
+		func(data, 0, count);
+		return;
+	}
+
+	// The caller keeps the first range: the rest are up for stealing meanwhile
+	JobCounter counter = { 0 };
+	for (int begin = grain; begin < count; begin += grain)
+	{
+		PushJob(AllocJob(func, data, begin, begin + grain < count ? begin + grain : count, &counter));
+	}
+	func(data, 0, grain < count ? grain : count);
+	WaitForJobs(&counter);
+}
@@ -0,0 +1,73 @@
+#include "layer_cache.h"
+
+static unsigned int layerEpoch = 0;
+
+unsigned int HashLayerInputs(unsigned int hash, const void* data, int size)
+{
+	if (hash == 0) hash = 2166136261u;
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (int i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool BeginCachedLayer(CachedLayer* layer, int width, int height, unsigned int inputsHash)
+{
+	bool resized = layer->target.id == 0 || layer->target.texture.width != width || layer->target.texture.height != height;
+	if (!resized && layer->valid && layer->inputsHash == inputsHash && layer->epoch == layerEpoch)
+	{
+		return false;
+	}
+
+	if (resized)
+	{
+		if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+		layer->target = LoadRenderTexture(width, height);
+	}
+
+	layer->inputsHash = inputsHash;
+	layer->valid = true;
+	layer->epoch = layerEpoch;
+	layer->redraws++;
+
+	BeginTextureMode(layer->target);
+	ClearBackground(BLANK);
+	return true;
+}
+
+void EndCachedLayer(CachedLayer* layer)
+{
+	(void)layer;
+	EndTextureMode();
+}
+
+Rectangle GetCachedLayerSource(const CachedLayer* layer)
+{
+	// Render textures are stored upside down
+	return (Rectangle){ 0, 0, (float)layer->target.texture.width, -(float)layer->target.texture.height };
+}
+
+void DrawCachedLayer(const CachedLayer* layer, Vector2 position)
+{
+	if (layer->target.id == 0) return;
+	DrawTextureRec(layer->target.texture, GetCachedLayerSource(layer), position, WHITE);
+}
+
+void InvalidateCachedLayer(CachedLayer* layer)
+{
+	layer->valid = false;
+}
+
+void InvalidateAllCachedLayers(void)
+{
+	layerEpoch++;
+}
+
+void UnloadCachedLayer(CachedLayer* layer)
+{
+	if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+	*layer = (CachedLayer){ 0 };
+}
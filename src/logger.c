@@ -0,0 +1,195 @@
+#include "logger.h"
+#include "platform.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Bounded MPMC queue after Dmitry Vyukov, used with a single consumer. Each slot carries
+// a sequence number: equal to the position when free for that lap, position + 1 once
+// written. Producers claim a position with one CAS and publish with a release store.
+
+typedef enum {
+	LOG_ORIGIN_GAME,
+	LOG_ORIGIN_RAYLIB
+} LogOrigin;
+
+typedef struct {
+	volatile long long sequence;
+	int level;
+	LogOrigin origin;
+	time_t timestamp;
+	char text[LOG_MESSAGE_MAX];
+} LogRecord;
+
+static LogRecord ring[LOG_RING_SIZE];
+static volatile long long enqueuePos = 0;
+static long long dequeuePos = 0; // Only touched by the writer thread
+static volatile long long running = 0;
+static PlatformThread* writer = NULL;
+static LoggerStats stats = { 0 };
+
+// Writer-side timestamp cache, strftime only runs when the second changes
+static time_t cachedSecond = 0;
+static char cachedTime[32] = { 0 };
+
+static void WriteRecord(const LogRecord* record)
+{
+	if (record->origin == LOG_ORIGIN_RAYLIB)
+	{
+		if (record->timestamp != cachedSecond)
+		{
+			cachedSecond = record->timestamp;
+			struct tm* tm_info = localtime(&cachedSecond);
+			strftime(cachedTime, sizeof(cachedTime), "%Y-%m-%d %H:%M:%S", tm_info);
+		}
+
+		const char* tag = "";
+		switch (record->level)
+		{
+		case LOG_INFO: tag = "[INFO] : "; break;
+		case LOG_ERROR: tag = "[ERROR]: "; break;
+		case LOG_WARNING: tag = "[WARN] : "; break;
+		case LOG_DEBUG: tag = "[DEBUG]: "; break;
+		default: break;
+		}
+		fprintf(stdout, "[%s] %s%s\n", cachedTime, tag, record->text);
+		return;
+	}
+
+	const char* tag = "[DEBUG]";
+	switch (record->level)
+	{
+	case LOG_INFO: tag = "[DEBUG INFO]"; break;
+	case LOG_WARNING: tag = "[DEBUG WARN]"; break;
+	case LOG_ERROR: case LOG_FATAL: tag = "[DEBUG ERROR]"; break;
+	default: break;
+	}
+	fprintf(stdout, "%s %s\n", tag, record->text);
+}
+
+static void PushRecord(int level, LogOrigin origin, const char* format, va_list args)
+{
+	if (!PlatformAtomicLoad64(&running))
+	{
+		// No writer yet (or any more): format in place, on the caller's thread
+		LogRecord record = { 0, level, origin, time(NULL), { 0 } };
+		vsnprintf(record.text, sizeof(record.text), format, args);
+		WriteRecord(&record);
+		return;
+	}
+
+	LogRecord* record;
+	long long pos = PlatformAtomicLoad64(&enqueuePos);
+	for (;;)
+	{
+		record = &ring[pos & (LOG_RING_SIZE - 1)];
+		long long diff = PlatformAtomicLoad64(&record->sequence) - pos;
+		if (diff == 0)
+		{
+			if (PlatformAtomicCas64(&enqueuePos, pos, pos + 1)) break;
+			pos = PlatformAtomicLoad64(&enqueuePos);
+		}
+		else if (diff < 0)
+		{
+			PlatformAtomicAdd64(&stats.dropped, 1); // Full, the writer is a whole lap behind
+			return;
+		}
+		else
+		{
+			pos = PlatformAtomicLoad64(&enqueuePos);
+		}
+	}
+
+	record->level = level;
+	record->origin = origin;
+	record->timestamp = time(NULL);
+	vsnprintf(record->text, sizeof(record->text), format, args);
+	PlatformAtomicStore64(&record->sequence, pos + 1);
+}
+
+// Writes every published record, returns how many there were
+static int DrainRecords(void)
+{
+	int count = 0;
+	for (;;)
+	{
+		LogRecord* record = &ring[dequeuePos & (LOG_RING_SIZE - 1)];
+		if (PlatformAtomicLoad64(&record->sequence) != dequeuePos + 1) break;
+
+		WriteRecord(record);
+		PlatformAtomicStore64(&record->sequence, dequeuePos + LOG_RING_SIZE);
+		dequeuePos++;
+		count++;
+	}
+	if (count > 0)
+	{
+		PlatformAtomicAdd64(&stats.written, count);
+		fflush(stdout);
+	}
+	return count;
+}
+
+static int LogWriterThread(void* arg)
+{
+	(void)arg;
+	for (;;)
+	{
+		if (DrainRecords() > 0) continue;
+		if (!PlatformAtomicLoad64(&running)) break;
+		PlatformSleep(0.002);
+	}
+	DrainRecords(); // Anything published while shutting down
+	return 0;
+}
+
+void InitLogger(void)
+{
+	if (writer) return;
+	for (long long i = 0; i < LOG_RING_SIZE; i++)
+	{
+		ring[i].sequence = i;
+	}
+	enqueuePos = 0;
+	dequeuePos = 0;
+
+	PlatformAtomicStore64(&running, 1);
+	writer = PlatformCreateThread(LogWriterThread, NULL);
+	if (!writer)
+	{
+		PlatformAtomicStore64(&running, 0);
+		DebugLog(LOG_WARNING, "Failed to start log writer, logging synchronously");
+	}
+}
+
+void ShutdownLogger(void)
+{
+	if (!writer) return;
+	PlatformAtomicStore64(&running, 0);
+	PlatformJoinThread(writer);
+	writer = NULL;
+	DrainRecords(); // A producer may have published after the writer's last pass
+
+	if (stats.dropped > 0)
+	{
+		DebugLog(LOG_WARNING, "Logger dropped %lld of %lld messages", stats.dropped, stats.dropped + stats.written);
+	}
+	fflush(stdout);
+}
+
+void DebugLog(int level, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	PushRecord(level, LOG_ORIGIN_GAME, format, args);
+	va_end(args);
+}
+
+void LogRaylibMessage(int level, const char* text, va_list args)
+{
+	PushRecord(level, LOG_ORIGIN_RAYLIB, text, args);
+}
+
+LoggerStats GetLoggerStats(void)
+{
+	return stats;
+}
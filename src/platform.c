@@ -0,0 +1,535 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // clock_gettime
+#endif
+
+#include "platform.h"
+#include <stdlib.h>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <stdio.h>
+
+struct PlatformThread { HANDLE handle; PlatformThreadFunc func; void* arg; };
+struct PlatformMutex { SRWLOCK lock; };
+struct PlatformCond { CONDITION_VARIABLE cond; };
+
+static DWORD WINAPI ThreadTrampoline(LPVOID param)
+{
+	PlatformThread* thread = (PlatformThread*)param;
+	return (DWORD)thread->func(thread->arg);
+}
+
+PlatformThread* PlatformCreateThread(PlatformThreadFunc func, void* arg)
+{
+	PlatformThread* thread = (PlatformThread*)malloc(sizeof(PlatformThread));
+	if (!thread) return NULL;
+	thread->func = func;
+	thread->arg = arg;
+	thread->handle = CreateThread(NULL, 0, ThreadTrampoline, thread, 0, NULL);
+	if (!thread->handle)
+	{
+		free(thread);
+		return NULL;
+	}
+	return thread;
+}
+
+void PlatformJoinThread(PlatformThread* thread)
+{
+	if (!thread) return;
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	free(thread);
+}
+
+PlatformMutex* PlatformCreateMutex(void)
+{
+	PlatformMutex* mutex = (PlatformMutex*)malloc(sizeof(PlatformMutex));
+	if (mutex) InitializeSRWLock(&mutex->lock);
+	return mutex;
+}
+
+void PlatformDestroyMutex(PlatformMutex* mutex) { free(mutex); }
+void PlatformLockMutex(PlatformMutex* mutex) { AcquireSRWLockExclusive(&mutex->lock); }
+void PlatformUnlockMutex(PlatformMutex* mutex) { ReleaseSRWLockExclusive(&mutex->lock); }
+
+PlatformCond* PlatformCreateCond(void)
+{
+	PlatformCond* cond = (PlatformCond*)malloc(sizeof(PlatformCond));
+	if (cond) InitializeConditionVariable(&cond->cond);
+	return cond;
+}
+
+void PlatformDestroyCond(PlatformCond* cond) { free(cond); }
+void PlatformWaitCond(PlatformCond* cond, PlatformMutex* mutex) { SleepConditionVariableSRW(&cond->cond, &mutex->lock, INFINITE, 0); }
+void PlatformSignalCond(PlatformCond* cond) { WakeConditionVariable(&cond->cond); }
+void PlatformBroadcastCond(PlatformCond* cond) { WakeAllConditionVariable(&cond->cond); }
+
+struct PlatformMappedFile { HANDLE file; HANDLE mapping; const void* view; };
+
+PlatformMappedFile* PlatformMapFile(const char* path, const void** data, size_t* size)
+{
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return NULL;
+
+	LARGE_INTEGER length;
+	if (!GetFileSizeEx(file, &length) || length.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+	PlatformMappedFile* mapped = view ? (PlatformMappedFile*)malloc(sizeof(PlatformMappedFile)) : NULL;
+	if (!mapped)
+	{
+		if (view) UnmapViewOfFile(view);
+		if (mapping) CloseHandle(mapping);
+		CloseHandle(file);
+		return NULL;
+	}
+
+	mapped->file = file;
+	mapped->mapping = mapping;
+	mapped->view = view;
+	*data = view;
+	*size = (size_t)length.QuadPart;
+	return mapped;
+}
+
+void PlatformUnmapFile(PlatformMappedFile* file)
+{
+	if (!file) return;
+	UnmapViewOfFile(file->view);
+	CloseHandle(file->mapping);
+	CloseHandle(file->file);
+	free(file);
+}
+
+struct PlatformWatcher {
+	HANDLE dir;
+	HANDLE cancel; // Set by PlatformCancelWatch()
+	OVERLAPPED overlapped; // hEvent is set when a read completes
+	bool reading; // A read is queued on dir
+	bool hasEvents;
+	DWORD eventOffset;
+	char root[MAX_PATH];
+	DWORD events[2048]; // FILE_NOTIFY_INFORMATION records, which must be DWORD aligned
+};
+
+// Changes that happen between two reads are buffered by the system for the handle
+static bool QueueWatchRead(PlatformWatcher* watcher)
+{
+	ResetEvent(watcher->overlapped.hEvent);
+	watcher->reading = ReadDirectoryChangesW(watcher->dir, watcher->events, sizeof(watcher->events), TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, NULL, &watcher->overlapped, NULL) != 0;
+	return watcher->reading;
+}
+
+PlatformWatcher* PlatformWatchDirectory(const char* path)
+{
+	PlatformWatcher* watcher = (PlatformWatcher*)calloc(1, sizeof(PlatformWatcher));
+	if (!watcher) return NULL;
+	watcher->dir = CreateFileA(path, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	watcher->cancel = CreateEventA(NULL, TRUE, FALSE, NULL);
+	watcher->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	snprintf(watcher->root, sizeof(watcher->root), "%s", path);
+	if (watcher->dir == INVALID_HANDLE_VALUE || !watcher->cancel || !watcher->overlapped.hEvent || !QueueWatchRead(watcher))
+	{
+		PlatformCloseWatcher(watcher);
+		return NULL;
+	}
+	return watcher;
+}
+
+bool PlatformWaitForFileChange(PlatformWatcher* watcher, char* path, int pathSize)
+{
+	for (;;)
+	{
+		while (watcher->hasEvents)
+		{
+			const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)((const char*)watcher->events + watcher->eventOffset);
+			watcher->hasEvents = info->NextEntryOffset != 0;
+			watcher->eventOffset += info->NextEntryOffset;
+			// Like IN_CLOSE_WRITE and IN_MOVED_TO; a new file is reported again once it has been written
+			if (info->Action != FILE_ACTION_MODIFIED && info->Action != FILE_ACTION_RENAMED_NEW_NAME) continue;
+
+			int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, (int)(info->FileNameLength / sizeof(WCHAR)), path, pathSize - 1, NULL, NULL);
+			if (length <= 0) continue;
+			path[length] = '\0';
+			for (char* c = path; *c; c++)
+			{
+				if (*c == '\\') *c = '/';
+			}
+			char full[MAX_PATH * 2];
+			snprintf(full, sizeof(full), "%s/%s", watcher->root, path);
+			DWORD attributes = GetFileAttributesA(full);
+			if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY)) continue; // Watched recursively already
+			return true;
+		}
+
+		// The records are read, the buffer can take the next batch
+		if (!watcher->reading && !QueueWatchRead(watcher)) return false;
+		HANDLE handles[2] = { watcher->overlapped.hEvent, watcher->cancel };
+		if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0) return false;
+
+		DWORD bytes = 0;
+		BOOL completed = GetOverlappedResult(watcher->dir, &watcher->overlapped, &bytes, FALSE);
+		watcher->reading = false;
+		if (!completed || bytes == 0) continue; // bytes is 0 when the system buffer overflowed: those changes are lost
+		watcher->hasEvents = true;
+		watcher->eventOffset = 0;
+	}
+}
+
+void PlatformCancelWatch(PlatformWatcher* watcher)
+{
+	if (watcher) SetEvent(watcher->cancel);
+}
+
+void PlatformCloseWatcher(PlatformWatcher* watcher)
+{
+	if (!watcher) return;
+	if (watcher->reading)
+	{
+		// The system writes into events until the read is done
+		DWORD bytes = 0;
+		CancelIoEx(watcher->dir, &watcher->overlapped);
+		GetOverlappedResult(watcher->dir, &watcher->overlapped, &bytes, TRUE);
+	}
+	if (watcher->dir != INVALID_HANDLE_VALUE && watcher->dir) CloseHandle(watcher->dir);
+	if (watcher->cancel) CloseHandle(watcher->cancel);
+	if (watcher->overlapped.hEvent) CloseHandle(watcher->overlapped.hEvent);
+	free(watcher);
+}
+
+double PlatformGetTime(void)
+{
+	static LARGE_INTEGER frequency = { 0 };
+	LARGE_INTEGER counter;
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+void PlatformSleep(double seconds)
+{
+	Sleep((DWORD)(seconds * 1000.0));
+}
+
+int PlatformGetCpuCount(void)
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+
+#include <pthread.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct PlatformThread { pthread_t handle; PlatformThreadFunc func; void* arg; };
+struct PlatformMutex { pthread_mutex_t lock; };
+struct PlatformCond { pthread_cond_t cond; };
+
+static void* ThreadTrampoline(void* param)
+{
+	PlatformThread* thread = (PlatformThread*)param;
+	thread->func(thread->arg);
+	return NULL;
+}
+
+PlatformThread* PlatformCreateThread(PlatformThreadFunc func, void* arg)
+{
+	PlatformThread* thread = (PlatformThread*)malloc(sizeof(PlatformThread));
+	if (!thread) return NULL;
+	thread->func = func;
+	thread->arg = arg;
+	if (pthread_create(&thread->handle, NULL, ThreadTrampoline, thread) != 0)
+	{
+		free(thread);
+		return NULL;
+	}
+	return thread;
+}
+
+void PlatformJoinThread(PlatformThread* thread)
+{
+	if (!thread) return;
+	pthread_join(thread->handle, NULL);
+	free(thread);
+}
+
+PlatformMutex* PlatformCreateMutex(void)
+{
+	PlatformMutex* mutex = (PlatformMutex*)malloc(sizeof(PlatformMutex));
+	if (mutex) pthread_mutex_init(&mutex->lock, NULL);
+	return mutex;
+}
+
+void PlatformDestroyMutex(PlatformMutex* mutex)
+{
+	if (!mutex) return;
+	pthread_mutex_destroy(&mutex->lock);
+	free(mutex);
+}
+
+void PlatformLockMutex(PlatformMutex* mutex) { pthread_mutex_lock(&mutex->lock); }
+void PlatformUnlockMutex(PlatformMutex* mutex) { pthread_mutex_unlock(&mutex->lock); }
+
+PlatformCond* PlatformCreateCond(void)
+{
+	PlatformCond* cond = (PlatformCond*)malloc(sizeof(PlatformCond));
+	if (cond) pthread_cond_init(&cond->cond, NULL);
+	return cond;
+}
+
+void PlatformDestroyCond(PlatformCond* cond)
+{
+	if (!cond) return;
+	pthread_cond_destroy(&cond->cond);
+	free(cond);
+}
+
+void PlatformWaitCond(PlatformCond* cond, PlatformMutex* mutex) { pthread_cond_wait(&cond->cond, &mutex->lock); }
+void PlatformSignalCond(PlatformCond* cond) { pthread_cond_signal(&cond->cond); }
+void PlatformBroadcastCond(PlatformCond* cond) { pthread_cond_broadcast(&cond->cond); }
+
+struct PlatformMappedFile { void* view; size_t size; };
+
+PlatformMappedFile* PlatformMapFile(const char* path, const void** data, size_t* size)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // The mapping keeps the file alive
+	if (view == MAP_FAILED) return NULL;
+
+	PlatformMappedFile* mapped = (PlatformMappedFile*)malloc(sizeof(PlatformMappedFile));
+	if (!mapped)
+	{
+		munmap(view, (size_t)info.st_size);
+		return NULL;
+	}
+	mapped->view = view;
+	mapped->size = (size_t)info.st_size;
+	*data = view;
+	*size = mapped->size;
+	return mapped;
+}
+
+void PlatformUnmapFile(PlatformMappedFile* file)
+{
+	if (!file) return;
+	munmap(file->view, file->size);
+	free(file);
+}
+
+#if defined(__linux__)
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <dirent.h>
+#include <string.h>
+#include <stdio.h>
+
+#define WATCHER_MAX_DIRS 256
+#define WATCHER_MAX_PATH 256
+
+struct PlatformWatcher {
+	int fd;
+	int wakeFds[2]; // Pipe written by PlatformCancelWatch()
+	int dirCount;
+	int wds[WATCHER_MAX_DIRS];
+	char dirs[WATCHER_MAX_DIRS][WATCHER_MAX_PATH]; // Relative to root, "" for root itself
+	char root[WATCHER_MAX_PATH];
+	int eventBytes;
+	int eventOffset;
+	_Alignas(struct inotify_event) char events[4096];
+};
+
+static void JoinWatchPath(char* out, int size, const char* dir, const char* name)
+{
+	if (dir[0]) snprintf(out, size, "%s/%s", dir, name);
+	else snprintf(out, size, "%s", name);
+}
+
+// inotify is not recursive: every directory gets its own watch
+static void WatchTree(PlatformWatcher* watcher, const char* relative)
+{
+	if (watcher->dirCount == WATCHER_MAX_DIRS) return;
+	char full[WATCHER_MAX_PATH * 2];
+	JoinWatchPath(full, sizeof(full), watcher->root, relative);
+	int wd = inotify_add_watch(watcher->fd, full, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR);
+	if (wd < 0) return;
+	watcher->wds[watcher->dirCount] = wd;
+	snprintf(watcher->dirs[watcher->dirCount], WATCHER_MAX_PATH, "%s", relative);
+	watcher->dirCount++;
+
+	DIR* dir = opendir(full);
+	if (!dir) return;
+	for (struct dirent* item = readdir(dir); item; item = readdir(dir))
+	{
+		if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) continue;
+		char child[WATCHER_MAX_PATH];
+		char childFull[WATCHER_MAX_PATH * 3];
+		JoinWatchPath(child, sizeof(child), relative, item->d_name);
+		JoinWatchPath(childFull, sizeof(childFull), watcher->root, child);
+		struct stat info;
+		if (stat(childFull, &info) == 0 && S_ISDIR(info.st_mode)) WatchTree(watcher, child);
+	}
+	closedir(dir);
+}
+
+PlatformWatcher* PlatformWatchDirectory(const char* path)
+{
+	PlatformWatcher* watcher = (PlatformWatcher*)calloc(1, sizeof(PlatformWatcher));
+	if (!watcher) return NULL;
+	watcher->fd = inotify_init1(IN_CLOEXEC);
+	if (watcher->fd < 0 || pipe(watcher->wakeFds) != 0)
+	{
+		if (watcher->fd >= 0) close(watcher->fd);
+		free(watcher);
+		return NULL;
+	}
+	snprintf(watcher->root, sizeof(watcher->root), "%s", path);
+	WatchTree(watcher, "");
+	if (watcher->dirCount == 0)
+	{
+		PlatformCloseWatcher(watcher);
+		return NULL;
+	}
+	return watcher;
+}
+
+bool PlatformWaitForFileChange(PlatformWatcher* watcher, char* path, int pathSize)
+{
+	for (;;)
+	{
+		while (watcher->eventOffset < watcher->eventBytes)
+		{
+			const struct inotify_event* event = (const struct inotify_event*)(watcher->events + watcher->eventOffset);
+			watcher->eventOffset += (int)sizeof(struct inotify_event) + (int)event->len;
+
+			const char* dir = NULL;
+			for (int i = 0; i < watcher->dirCount && !dir; i++)
+			{
+				if (watcher->wds[i] == event->wd) dir = watcher->dirs[i];
+			}
+			if (!dir || event->len == 0) continue;
+
+			char relative[WATCHER_MAX_PATH];
+			JoinWatchPath(relative, sizeof(relative), dir, event->name);
+			if (event->mask & IN_ISDIR)
+			{
+				WatchTree(watcher, relative);
+				continue;
+			}
+			if (event->mask & IN_CREATE) continue; // Reported again once it has been written
+			snprintf(path, pathSize, "%s", relative);
+			return true;
+		}
+
+		struct pollfd fds[2] = { { watcher->fd, POLLIN, 0 }, { watcher->wakeFds[0], POLLIN, 0 } };
+		if (poll(fds, 2, -1) < 0) continue; // Interrupted
+		if (fds[1].revents) return false;
+		ssize_t bytes = read(watcher->fd, watcher->events, sizeof(watcher->events));
+		if (bytes <= 0) continue;
+		watcher->eventBytes = (int)bytes;
+		watcher->eventOffset = 0;
+	}
+}
+
+void PlatformCancelWatch(PlatformWatcher* watcher)
+{
+	if (watcher && write(watcher->wakeFds[1], "x", 1) < 0) {}
+}
+
+void PlatformCloseWatcher(PlatformWatcher* watcher)
+{
+	if (!watcher) return;
+	close(watcher->fd);
+	close(watcher->wakeFds[0]);
+	close(watcher->wakeFds[1]);
+	free(watcher);
+}
+
+#else
+
+PlatformWatcher* PlatformWatchDirectory(const char* path) { (void)path; return NULL; }
+bool PlatformWaitForFileChange(PlatformWatcher* watcher, char* path, int pathSize) { (void)watcher; (void)path; (void)pathSize; return false; }
+void PlatformCancelWatch(PlatformWatcher* watcher) { (void)watcher; }
+void PlatformCloseWatcher(PlatformWatcher* watcher) { (void)watcher; }
+
+#endif
+
+double PlatformGetTime(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void PlatformSleep(double seconds)
+{
+	struct timespec ts;
+	ts.tv_sec = (time_t)seconds;
+	ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+	nanosleep(&ts, NULL);
+}
+
+int PlatformGetCpuCount(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+}
+
+#endif
+
+// ------ CPU features ------
+#if defined(PLATFORM_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+PlatformCpuFeatures PlatformGetCpuFeatures(void)
+{
+	PlatformCpuFeatures features = { 0 };
+#if defined(PLATFORM_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+	{
+		__cpuidex(info, 7, 0);
+		features.avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#elif defined(PLATFORM_X86)
+	__builtin_cpu_init();
+	features.sse2 = __builtin_cpu_supports("sse2");
+	features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+	return features;
+}
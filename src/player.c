@@ -0,0 +1,99 @@
+#include "player.h"
+#include "game.h"
+#include "asset_cache.h"
+#include "input.h"
+
+Player CreatePlayer(EntityWorld* world, const char* animationPath, Vector2 startPos)
+{
+	Player player = { 0 };
+	player.world = world;
+	player.entity = SpawnEntity(world, startPos, "player");
+	player.atlas = AcquireAtlas(&spriteAtlas);
+	player.animations = AcquireAnimationSet(animationPath, player.atlas);
+	player.isRunning = false;
+	player.walkArea = (Rectangle){ 0, 0, (float)GetGameWidth(), (float)GetGameHeight() };
+
+	int i = GetEntityIndex(world, player.entity);
+	if (i >= 0) world->direction[i] = -1.0f; // Initially facing right
+	SetEntityAnimation(world, player.entity, player.animations);
+	return player;
+}
+
+void UpdatePlayer(Player* player, float dt)
+{
+	EntityWorld* world = player->world;
+	int i = GetEntityIndex(world, player->entity);
+	if (i < 0) return;
+
+	const InputState* input = GetInput();
+	bool moving = false;
+	float* x = &world->posX[i];
+	float left = player->walkArea.x;
+	float right = player->walkArea.x + player->walkArea.width - world->frameWidth[i];
+	player->isRunning = false;
+
+	if (input->down[ACTION_MOVE_RIGHT])
+	{
+		// Prevent moving off right edge
+		if (*x < right)
+		{
+			*x += PLAYER_WALK_SPEED * dt;
+		}
+		else
+		{
+			*x = right;
+		}
+		moving = true;
+		world->direction[i] = -1.0f; // Facing right
+	}
+	if (input->down[ACTION_MOVE_LEFT])
+	{
+		// Prevent moving off left edge
+		if (*x > left)
+		{
+			*x -= PLAYER_WALK_SPEED * dt;
+		}
+		else
+		{
+			*x = left;
+		}
+		moving = true;
+		world->direction[i] = 1.0f; // Facing left
+	}
+
+	if (moving && input->down[ACTION_RUN])
+	{
+		player->isRunning = true;
+		*x += -PLAYER_RUN_SPEED * world->direction[i] * dt;
+	}
+
+	// AnimateEntities plays the state's clip
+	world->state[i] = !moving ? IDLE : player->isRunning ? RUNNING : WALKING;
+}
+
+void FreePlayer(Player* player)
+{
+	DespawnEntity(player->world, player->entity);
+	ReleaseAnimationSet(player->animations);
+	ReleaseAtlas(player->atlas);
+}
+
+Vector2 GetPlayerPosition(const Player* player)
+{
+	int i = GetEntityIndex(player->world, player->entity);
+	if (i < 0) return (Vector2) { 0, 0 };
+	return (Vector2) { player->world->posX[i], player->world->posY[i] };
+}
+
+Vector2 GetPlayerSize(const Player* player)
+{
+	int i = GetEntityIndex(player->world, player->entity);
+	if (i < 0) return (Vector2) { 0, 0 };
+	return (Vector2) { player->world->frameWidth[i], player->world->frameHeight[i] };
+}
+
+int GetPlayerFrame(const Player* player)
+{
+	int i = GetEntityIndex(player->world, player->entity);
+	return i < 0 ? 0 : player->world->animFrame[i];
+}
@@ -0,0 +1,344 @@
+#include "profiler.h"
+
+#if CELISE_PROFILE
+
+#include "raylib.h"
+#include "platform.h"
+#include "logger.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILER_THREAD_LOCAL _Thread_local
+#endif
+
+typedef struct {
+	const char* category;
+	const char* name;
+	double start;
+	double end;
+	int depth;
+} ZoneRecord;
+
+// Written only by its own thread. head is published with a release store after the
+// record, so readers see whole records up to it. A reader that finds the writer has
+// lapped a record while it was being copied throws the copy away.
+typedef struct {
+	ZoneRecord records[PROFILER_RING_SIZE];
+	volatile long long head;
+	long long folded; // Main thread only: zones up to here are in the overlay statistics
+	ZoneRecord open[PROFILER_MAX_DEPTH];
+	int depth;
+	const char* name;
+} ProfilerThread;
+
+typedef struct {
+	const char* category;
+	const char* name;
+	int thread;
+	int depth;
+	double firstStart; // Rows are listed in the order zones first ran
+	double frameMs; // Accumulating for the frame being folded
+	int frameCalls;
+	double lastMs;
+	int lastCalls;
+	double avgMs;
+	double maxMs; // Over the previous PROFILER_HISTORY frames
+	double windowMaxMs;
+} ZoneStats;
+
+static ProfilerThread threads[PROFILER_MAX_THREADS];
+static volatile long long threadCount = 0;
+static PROFILER_THREAD_LOCAL int threadSlot = 0; // Index + 1, -1 when every slot is taken
+
+// Main thread only
+static ZoneStats zones[PROFILER_MAX_ZONES];
+static int zoneCount = 0;
+static long long droppedZones = 0;
+static float frameTimes[PROFILER_HISTORY];
+static long long frameCount = 0;
+static double lastFrameTime = 0.0;
+static bool frameOpen = false;
+
+static ProfilerThread* CurrentThread(void)
+{
+	if (threadSlot == 0)
+	{
+		long long index = PlatformAtomicAdd64(&threadCount, 1);
+		threadSlot = index < PROFILER_MAX_THREADS ? (int)index + 1 : -1;
+	}
+	return threadSlot > 0 ? &threads[threadSlot - 1] : NULL;
+}
+
+static int GetThreadCount(void)
+{
+	long long count = PlatformAtomicLoad64(&threadCount);
+	return count < PROFILER_MAX_THREADS ? (int)count : PROFILER_MAX_THREADS;
+}
+
+// Copies the record at pos, false if the writer may have overwritten it meanwhile
+static bool ReadRecord(ProfilerThread* thread, long long pos, ZoneRecord* out)
+{
+	*out = thread->records[pos & (PROFILER_RING_SIZE - 1)];
+	return PlatformAtomicLoad64(&thread->head) - pos < PROFILER_RING_SIZE;
+}
+
+void ProfileBegin(const char* category, const char* name)
+{
+	ProfilerThread* thread = CurrentThread();
+	if (!thread) return;
+	if (thread->depth < PROFILER_MAX_DEPTH)
+	{
+		thread->open[thread->depth] = (ZoneRecord){ category, name, PlatformGetTime(), 0.0, thread->depth };
+	}
+	thread->depth++; // Zones nested deeper than PROFILER_MAX_DEPTH are not recorded
+}
+
+static void EndZone(const char* name)
+{
+	ProfilerThread* thread = CurrentThread();
+	if (!thread || thread->depth == 0) return;
+	thread->depth--;
+	if (thread->depth >= PROFILER_MAX_DEPTH) return;
+
+	long long head = thread->head;
+	ZoneRecord* record = &thread->records[head & (PROFILER_RING_SIZE - 1)];
+	*record = thread->open[thread->depth];
+	record->end = PlatformGetTime();
+	if (name) record->name = name;
+	PlatformAtomicStore64(&thread->head, head + 1);
+}
+
+void ProfileEnd(void)
+{
+	EndZone(NULL);
+}
+
+void ProfileEndAs(const char* name)
+{
+	EndZone(name);
+}
+
+void ProfileThreadName(const char* name)
+{
+	ProfilerThread* thread = CurrentThread();
+	if (thread) thread->name = name;
+}
+
+// ------ Per-frame statistics ------
+
+static ZoneStats* FindZone(const ZoneRecord* record, int thread)
+{
+	for (int i = 0; i < zoneCount; i++)
+	{
+		ZoneStats* zone = &zones[i];
+		if (zone->thread == thread &&
+			(zone->name == record->name || strcmp(zone->name, record->name) == 0) &&
+			(zone->category == record->category || strcmp(zone->category, record->category) == 0))
+		{
+			return zone;
+		}
+	}
+	if (zoneCount == PROFILER_MAX_ZONES) return NULL;
+
+	// Keep rows sorted by thread, then by when the zone first started
+	int at = zoneCount;
+	while (at > 0 && (zones[at - 1].thread > thread || (zones[at - 1].thread == thread && zones[at - 1].firstStart > record->start)))
+	{
+		zones[at] = zones[at - 1];
+		at--;
+	}
+	zones[at] = (ZoneStats){ record->category, record->name, thread, record->depth, record->start };
+	zoneCount++;
+	return &zones[at];
+}
+
+static void FoldZones(void)
+{
+	int count = GetThreadCount();
+	for (int t = 0; t < count; t++)
+	{
+		ProfilerThread* thread = &threads[t];
+		long long head = PlatformAtomicLoad64(&thread->head);
+		long long pos = thread->folded;
+		if (head - pos > PROFILER_RING_SIZE)
+		{
+			droppedZones += head - pos - PROFILER_RING_SIZE;
+			pos = head - PROFILER_RING_SIZE;
+		}
+		for (; pos < head; pos++)
+		{
+			ZoneRecord record;
+			if (!ReadRecord(thread, pos, &record))
+			{
+				droppedZones++;
+				continue;
+			}
+			ZoneStats* zone = FindZone(&record, t);
+			if (!zone) continue;
+			zone->frameMs += (record.end - record.start) * 1000.0;
+			zone->frameCalls++;
+		}
+		thread->folded = head;
+	}
+
+	bool windowDone = frameCount % PROFILER_HISTORY == 0;
+	for (int i = 0; i < zoneCount; i++)
+	{
+		ZoneStats* zone = &zones[i];
+		zone->lastMs = zone->frameMs;
+		zone->lastCalls = zone->frameCalls;
+		zone->avgMs += (zone->lastMs - zone->avgMs) * 0.05;
+		if (zone->lastMs > zone->windowMaxMs) zone->windowMaxMs = zone->lastMs;
+		if (windowDone)
+		{
+			zone->maxMs = zone->windowMaxMs;
+			zone->windowMaxMs = 0.0;
+		}
+		zone->frameMs = 0.0;
+		zone->frameCalls = 0;
+	}
+}
+
+void ProfileFrame(void)
+{
+	if (frameOpen) ProfileEnd();
+
+	double now = PlatformGetTime();
+	if (lastFrameTime > 0.0)
+	{
+		frameTimes[frameCount % PROFILER_HISTORY] = (float)((now - lastFrameTime) * 1000.0);
+		frameCount++;
+	}
+	lastFrameTime = now;
+	FoldZones();
+
+	ProfileBegin("frame", "Frame"); // Everything the main thread times until the next call nests in it
+	frameOpen = true;
+}
+
+// ------ Overlay ------
+
+#define OVERLAY_ROW 18
+#define OVERLAY_GRAPH_HEIGHT 60
+#define OVERLAY_BUCKET_MS 2
+#define OVERLAY_BUCKETS 20
+
+void DrawProfilerOverlay(void)
+{
+	int x = 10;
+	int y = 10;
+	int width = 520;
+	int height = 40 + zoneCount * OVERLAY_ROW + 2 * (OVERLAY_GRAPH_HEIGHT + 24);
+	DrawRectangle(x, y, width, height, Fade(BLACK, 0.8f));
+
+	int cx = x + 8;
+	int cy = y + 6;
+	DrawText(TextFormat("zone (ms)%*s last      avg      max  calls", 25, ""), cx, cy, 10, GRAY);
+	if (droppedZones > 0) DrawText(TextFormat("%lld dropped", droppedZones), x + width - 90, cy, 10, RED);
+	cy += OVERLAY_ROW;
+
+	for (int i = 0; i < zoneCount; i++)
+	{
+		const ZoneStats* zone = &zones[i];
+		const char* thread = threads[zone->thread].name;
+		Color color = zone->thread == 0 ? RAYWHITE : SKYBLUE;
+		DrawText(TextFormat("%s %s", zone->name, zone->category), cx + zone->depth * 10, cy, 10, color);
+		if (zone->thread != 0) DrawText(thread ? thread : TextFormat("thread %d", zone->thread), cx + 200, cy, 10, GRAY);
+		DrawText(TextFormat("%8.3f %8.3f %8.3f  %d", zone->lastMs, zone->avgMs, zone->maxMs, zone->lastCalls), cx + 260, cy, 10, color);
+		cy += OVERLAY_ROW;
+	}
+
+	// Frame times, oldest on the left, with the 60 Hz budget marked
+	cy += 6;
+	int frames = frameCount < PROFILER_HISTORY ? (int)frameCount : PROFILER_HISTORY;
+	float barWidth = (float)(width - 16) / PROFILER_HISTORY;
+	float pixelsPerMs = OVERLAY_GRAPH_HEIGHT / 33.3f;
+	DrawText("frame time", cx, cy, 10, GRAY);
+	cy += 14;
+	for (int i = 0; i < frames; i++)
+	{
+		float ms = frameTimes[(frameCount - frames + i) % PROFILER_HISTORY];
+		float barHeight = ms * pixelsPerMs > OVERLAY_GRAPH_HEIGHT ? OVERLAY_GRAPH_HEIGHT : ms * pixelsPerMs;
+		Color color = ms <= 16.7f ? LIME : ms <= 33.3f ? YELLOW : RED;
+		DrawRectangleRec((Rectangle){ cx + i * barWidth, cy + OVERLAY_GRAPH_HEIGHT - barHeight, barWidth - 1, barHeight }, color);
+	}
+	DrawLine(cx, cy + OVERLAY_GRAPH_HEIGHT - (int)(16.7f * pixelsPerMs), cx + width - 16, cy + OVERLAY_GRAPH_HEIGHT - (int)(16.7f * pixelsPerMs), Fade(WHITE, 0.5f));
+	cy += OVERLAY_GRAPH_HEIGHT + 10;
+
+	// Histogram of the same frames, in OVERLAY_BUCKET_MS buckets; the last one takes everything slower
+	int buckets[OVERLAY_BUCKETS] = { 0 };
+	int tallest = 1;
+	for (int i = 0; i < frames; i++)
+	{
+		int bucket = (int)(frameTimes[i] / OVERLAY_BUCKET_MS);
+		if (bucket >= OVERLAY_BUCKETS) bucket = OVERLAY_BUCKETS - 1;
+		if (++buckets[bucket] > tallest) tallest = buckets[bucket];
+	}
+	DrawText(TextFormat("histogram, %d ms buckets", OVERLAY_BUCKET_MS), cx, cy, 10, GRAY);
+	cy += 14;
+	float bucketWidth = (float)(width - 16) / OVERLAY_BUCKETS;
+	for (int i = 0; i < OVERLAY_BUCKETS; i++)
+	{
+		float barHeight = (float)buckets[i] / tallest * OVERLAY_GRAPH_HEIGHT;
+		Color color = (i + 1) * OVERLAY_BUCKET_MS <= 17 ? LIME : (i + 1) * OVERLAY_BUCKET_MS <= 34 ? YELLOW : RED;
+		DrawRectangleRec((Rectangle){ cx + i * bucketWidth, cy + OVERLAY_GRAPH_HEIGHT - barHeight, bucketWidth - 2, barHeight }, color);
+	}
+}
+
+// ------ Trace export ------
+
+static void WriteJsonString(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (const char* c = text ? text : ""; *c; c++)
+	{
+		if (*c == '"' || *c == '\\') fputc('\\', file);
+		if ((unsigned char)*c >= 0x20) fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+bool ExportProfilerTrace(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		DebugLog(LOG_WARNING, "Could not write profiler trace <%s>", path);
+		return false;
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	int written = 0;
+	int count = GetThreadCount();
+	for (int t = 0; t < count; t++)
+	{
+		ProfilerThread* thread = &threads[t];
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", t == 0 ? "" : ",\n", t + 1);
+		WriteJsonString(file, thread->name ? thread->name : TextFormat("thread %d", t + 1));
+		fprintf(file, "}}");
+
+		long long head = PlatformAtomicLoad64(&thread->head);
+		for (long long pos = head > PROFILER_RING_SIZE ? head - PROFILER_RING_SIZE : 0; pos < head; pos++)
+		{
+			ZoneRecord record;
+			if (!ReadRecord(thread, pos, &record)) continue;
+			fprintf(file, ",\n{\"name\":");
+			WriteJsonString(file, record.name);
+			fprintf(file, ",\"cat\":");
+			WriteJsonString(file, record.category);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				t + 1, record.start * 1e6, (record.end - record.start) * 1e6);
+			written++;
+		}
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	DebugLog(LOG_INFO, "Wrote %d profiler zones to <%s>", written, path);
+	return true;
+}
+
+#endif
@@ -0,0 +1,641 @@
+#include "save.h"
+#include "game.h"
+#include "scenes.h"
+#include "platform.h"
+#include "logger.h"
+#include "profiler.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SAVE_MAX_ITEM_SLOTS 256
+
+// Every section of one save, serialized. Three of them rotate between the main thread
+// (staging), the queue (pending) and the writer thread (writing).
+typedef struct {
+	char path[SAVE_MAX_PATH];
+	uint32_t sizes[SAVE_SECTION_COUNT];
+	uint32_t hashes[SAVE_SECTION_COUNT];
+	unsigned char data[SAVE_SECTION_COUNT][SAVE_MAX_SECTION_SIZE];
+} SaveSnapshot;
+
+typedef struct {
+	bool ok;
+	bool compacted;
+	int written;
+	int skipped;
+	long long bytes;
+} WriteResult;
+
+static const uint32_t sectionVersions[SAVE_SECTION_COUNT] = { 1, 1, 2, 1 };
+static const uint32_t oldestSectionVersions[SAVE_SECTION_COUNT] = { 1, 1, 1, 1 }; // Still loaded
+static const unsigned char fileHeader[SAVE_ALIGNMENT] = { 'C', 'S', 'A', 'V' }; // Keeps offset 0 free to mean "missing"
+
+static SaveSnapshot snapshots[3];
+static SaveSnapshot* staging = &snapshots[0];
+static SaveSnapshot* pending = &snapshots[1];
+static SaveSnapshot* writing = &snapshots[2];
+static bool hasPending = false;
+static bool writerBusy = false;
+static bool writerQuit = false;
+
+static PlatformThread* writer = NULL;
+static PlatformMutex* lock = NULL;
+static PlatformCond* workAvailable = NULL;
+static PlatformCond* writerIdle = NULL;
+static SaveStats stats = { 0 };
+
+// FNV-1a, like the bundle's path hash
+static uint32_t HashBytes(const void* data, size_t size)
+{
+	uint32_t hash = 2166136261u;
+	for (const unsigned char* c = (const unsigned char*)data; size > 0; c++, size--)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// ------ Serialization ------
+
+typedef struct {
+	unsigned char* data;
+	uint32_t size;
+	bool overflow;
+} SectionWriter;
+
+// Appends size zeroed bytes on a 4-byte boundary, returns their offset. Padding is zeroed
+// too, so identical state always hashes the same.
+static uint32_t Reserve(SectionWriter* writer, uint32_t size)
+{
+	uint32_t offset = (writer->size + 3u) & ~3u;
+	if (writer->overflow || offset + size > SAVE_MAX_SECTION_SIZE)
+	{
+		writer->overflow = true;
+		return 0;
+	}
+	memset(writer->data + writer->size, 0, offset + size - writer->size);
+	writer->size = offset + size;
+	return offset;
+}
+
+static uint32_t WriteBytes(SectionWriter* writer, const void* data, uint32_t size)
+{
+	uint32_t offset = Reserve(writer, size);
+	if (!writer->overflow) memcpy(writer->data + offset, data, size);
+	return offset;
+}
+
+static uint32_t WriteString(SectionWriter* writer, const char* text)
+{
+	return WriteBytes(writer, text, (uint32_t)strlen(text) + 1);
+}
+
+static bool SerializePlayer(SectionWriter* writer)
+{
+	EntityWorld* world = GetEntityWorld();
+	int index = GetEntityIndex(world, GetPlayer()->entity);
+	Scene* scene = GetFocusScene(globalSceneStack);
+	if (index < 0 || !scene) return false;
+
+	SavePlayerSection section = { world->posX[index], world->posY[index], world->direction[index], (int32_t)scene->id };
+	WriteBytes(writer, &section, sizeof(section));
+	return true;
+}
+
+static bool SerializeCharacter(SectionWriter* writer)
+{
+	const Character* character = &GetPlayerData()->character;
+	const Attributes* attributes = GetPlayerAttributes();
+	uint32_t at = Reserve(writer, sizeof(SaveCharacterSection));
+	SaveCharacterSection section = {
+		character->charHeight, character->charWeight,
+		attributes->STRENGTH, attributes->CHARISMA, attributes->WISDOM,
+		attributes->INTELLIGENCE, attributes->DEXTERITY, attributes->VITALITY,
+		WriteString(writer, character->charName ? character->charName : ""), 0
+	};
+	if (!writer->overflow) memcpy(writer->data + at, &section, sizeof(section));
+	return true;
+}
+
+static bool SerializeInventory(SectionWriter* writer)
+{
+	const Inventory* inventory = &GetPlayerData()->inv;
+	if (inventory->capacity > SAVE_MAX_ITEM_SLOTS) return false;
+
+	uint32_t at = Reserve(writer, sizeof(SaveInventorySection));
+	uint32_t slotsAt = Reserve(writer, sizeof(SaveInventorySlot) * inventory->usedSlots);
+	if (writer->overflow) return false;
+
+	// Each distinct item's key is stored once, slots refer to it by index
+	uint32_t keyIndices[MAX_ITEMS + 1];
+	ItemId keys[SAVE_MAX_ITEM_SLOTS];
+	memset(keyIndices, 0xFF, sizeof(keyIndices));
+	uint32_t keyCount = 0;
+	uint32_t slotCount = 0;
+	for (int slot = 0; slot < inventory->capacity; slot++)
+	{
+		InventorySlot stack = inventory->slots[slot];
+		if (stack.item == ITEM_NONE) continue;
+		if (keyIndices[stack.item] == SAVE_EMPTY_SLOT)
+		{
+			keys[keyCount] = stack.item;
+			keyIndices[stack.item] = keyCount++;
+		}
+		SaveInventorySlot saved = { (uint16_t)slot, stack.count, keyIndices[stack.item] };
+		memcpy(writer->data + slotsAt + slotCount++ * sizeof(saved), &saved, sizeof(saved));
+	}
+
+	uint32_t keysAt = Reserve(writer, sizeof(uint32_t) * keyCount);
+	for (uint32_t i = 0; i < keyCount && !writer->overflow; i++)
+	{
+		uint32_t offset = WriteString(writer, GetItemKey(keys[i]));
+		memcpy(writer->data + keysAt + i * sizeof(uint32_t), &offset, sizeof(offset));
+	}
+
+	SaveInventorySection section = { inventory->capacity, keyCount, keysAt, slotCount, slotsAt, 0 };
+	if (!writer->overflow) memcpy(writer->data + at, &section, sizeof(section));
+	return true;
+}
+
+static bool SerializeHud(SectionWriter* writer)
+{
+	SaveHudSection section = { top_bar_context.gold, top_bar_context.hp_percentage, GetGameMinutes() };
+	WriteBytes(writer, &section, sizeof(section));
+	return true;
+}
+
+static bool (*const serializers[SAVE_SECTION_COUNT])(SectionWriter* writer) = {
+	SerializePlayer,
+	SerializeCharacter,
+	SerializeInventory,
+	SerializeHud
+};
+
+// ------ Footer ------
+
+static void SealFooter(SaveFooter* footer)
+{
+	footer->version = SAVE_VERSION;
+	footer->magic = SAVE_MAGIC;
+	footer->hash = HashBytes(footer, offsetof(SaveFooter, hash));
+}
+
+// The footer must end at or before end, and every section it lists must hash as recorded
+static bool IsFooterValid(const SaveFooter* footer, const unsigned char* data, size_t end)
+{
+	if (footer->magic != SAVE_MAGIC || footer->version != SAVE_VERSION) return false;
+	if (footer->hash != HashBytes(footer, offsetof(SaveFooter, hash))) return false;
+	for (int i = 0; i < SAVE_SECTION_COUNT; i++)
+	{
+		const SaveSectionEntry* entry = &footer->sections[i];
+		if (entry->offset == 0) continue;
+		if (entry->offset % SAVE_ALIGNMENT != 0 || entry->size > SAVE_MAX_SECTION_SIZE ||
+			(size_t)entry->offset + entry->size > end)
+		{
+			return false;
+		}
+		if (HashBytes(data + entry->offset, entry->size) != entry->hash) return false;
+	}
+	return true;
+}
+
+// The last valid footer. A torn write can only have added one snapshot's worth of bytes
+// after it, so the search gives up beyond that.
+static bool FindFooter(const unsigned char* data, size_t size, SaveFooter* footer)
+{
+	if (size < sizeof(SaveFooter)) return false;
+	size_t last = (size - sizeof(SaveFooter)) & ~(size_t)(SAVE_ALIGNMENT - 1);
+	size_t limit = SAVE_SECTION_COUNT * (SAVE_MAX_SECTION_SIZE + SAVE_ALIGNMENT) + 2 * sizeof(SaveFooter);
+	for (size_t pos = last;; pos -= SAVE_ALIGNMENT)
+	{
+		memcpy(footer, data + pos, sizeof(SaveFooter));
+		if (IsFooterValid(footer, data, pos)) return true;
+		if (pos < SAVE_ALIGNMENT || last - pos >= limit) return false;
+	}
+}
+
+// ------ Writer thread ------
+
+static bool WritePadded(FILE* file, long long* pos, const void* data, size_t size)
+{
+	static const unsigned char zeros[SAVE_ALIGNMENT] = { 0 };
+	size_t padding = (size_t)((SAVE_ALIGNMENT - *pos % SAVE_ALIGNMENT) % SAVE_ALIGNMENT);
+	if (fwrite(zeros, 1, padding, file) != padding || fwrite(data, 1, size, file) != size) return false;
+	*pos += (long long)(padding + size);
+	return true;
+}
+
+// Writes the sections that differ from footer (all of them when rewriting), then the updated footer
+static bool WriteSections(FILE* file, long long pos, const SaveSnapshot* snapshot, SaveFooter* footer, bool rewrite, WriteResult* result)
+{
+	long long start = pos;
+	footer->liveSize = 0;
+	for (int i = 0; i < SAVE_SECTION_COUNT; i++)
+	{
+		SaveSectionEntry* entry = &footer->sections[i];
+		SaveSectionEntry wanted = { 0, snapshot->sizes[i], sectionVersions[i], snapshot->hashes[i] };
+		if (!rewrite && entry->offset != 0 && entry->size == wanted.size && entry->version == wanted.version && entry->hash == wanted.hash)
+		{
+			result->skipped++;
+		}
+		else
+		{
+			if (!WritePadded(file, &pos, snapshot->data[i], snapshot->sizes[i])) return false;
+			wanted.offset = (uint32_t)(pos - snapshot->sizes[i]);
+			*entry = wanted;
+			result->written++;
+		}
+		footer->liveSize += entry->size;
+	}
+	footer->generation++;
+	SealFooter(footer);
+	if (!WritePadded(file, &pos, footer, sizeof(SaveFooter))) return false;
+	result->bytes = pos - start;
+	return true;
+}
+
+static WriteResult WriteSnapshot(const SaveSnapshot* snapshot)
+{
+	WriteResult result = { 0 };
+	PROFILE_BEGIN("save", "WriteSnapshot");
+
+	// Where the file stands now; it is unmapped again before writing to it
+	SaveFooter footer = { 0 };
+	long long size = 0;
+	bool append = false;
+	const void* data = NULL;
+	size_t mappedSize = 0;
+	PlatformMappedFile* mapped = PlatformMapFile(snapshot->path, &data, &mappedSize);
+	if (mapped)
+	{
+		append = FindFooter((const unsigned char*)data, mappedSize, &footer);
+		size = (long long)mappedSize;
+		PlatformUnmapFile(mapped);
+	}
+	if (!append) footer = (SaveFooter){ 0 };
+
+	// Appends pile up dead copies of the sections; past the ratio, start the file over
+	long long live = sizeof(SaveFooter);
+	for (int i = 0; i < SAVE_SECTION_COUNT; i++) live += snapshot->sizes[i] + SAVE_ALIGNMENT;
+	if (append && size > live * SAVE_COMPACT_RATIO)
+	{
+		append = false;
+		result.compacted = true;
+	}
+
+	if (append)
+	{
+		FILE* file = fopen(snapshot->path, "ab");
+		result.ok = file && WriteSections(file, size, snapshot, &footer, false, &result);
+		if (file) result.ok = fclose(file) == 0 && result.ok;
+	}
+	else
+	{
+		// Written beside the old file and renamed over it, so the old save survives a failed write
+		char tempPath[SAVE_MAX_PATH + 8];
+		snprintf(tempPath, sizeof(tempPath), "%s.tmp", snapshot->path);
+		FILE* file = fopen(tempPath, "wb");
+		long long pos = 0;
+		result.ok = file && WritePadded(file, &pos, fileHeader, sizeof(fileHeader)) && WriteSections(file, pos, snapshot, &footer, true, &result);
+		if (file) result.ok = fclose(file) == 0 && result.ok;
+#if defined(_WIN32)
+		if (result.ok) remove(snapshot->path); // rename() does not replace on Windows
+#endif
+		result.ok = result.ok && rename(tempPath, snapshot->path) == 0;
+		if (!result.ok) remove(tempPath);
+	}
+
+	if (!result.ok) DebugLog(LOG_ERROR, "Failed to write save <%s>", snapshot->path);
+	PROFILE_END();
+	return result;
+}
+
+static void RecordWrite(const WriteResult* result, double seconds)
+{
+	stats.sectionsWritten += result->written;
+	stats.sectionsSkipped += result->skipped;
+	stats.bytesWritten += result->bytes;
+	if (result->compacted) stats.compactions++;
+	stats.lastWriteMs = seconds * 1000.0;
+}
+
+static int SaveWriter(void* arg)
+{
+	(void)arg;
+	PROFILE_THREAD_NAME("save writer");
+	PlatformLockMutex(lock);
+	for (;;)
+	{
+		if (!hasPending)
+		{
+			if (writerQuit) break;
+			PlatformWaitCond(workAvailable, lock);
+			continue;
+		}
+
+		SaveSnapshot* swap = writing;
+		writing = pending;
+		pending = swap;
+		hasPending = false;
+		writerBusy = true;
+		PlatformUnlockMutex(lock);
+
+		double start = PlatformGetTime();
+		WriteResult result = WriteSnapshot(writing);
+		double elapsed = PlatformGetTime() - start;
+
+		PlatformLockMutex(lock);
+		RecordWrite(&result, elapsed);
+		writerBusy = false;
+		PlatformBroadcastCond(writerIdle);
+	}
+	PlatformUnlockMutex(lock);
+	return 0;
+}
+
+void InitSaveSystem(void)
+{
+	lock = PlatformCreateMutex();
+	workAvailable = PlatformCreateCond();
+	writerIdle = PlatformCreateCond();
+	writerQuit = false;
+	hasPending = false;
+	writer = PlatformCreateThread(SaveWriter, NULL);
+	if (!writer)
+	{
+		DebugLog(LOG_WARNING, "Failed to start save writer, saves will be written on the main thread");
+	}
+}
+
+void ShutdownSaveSystem(void)
+{
+	if (writer)
+	{
+		PlatformLockMutex(lock);
+		writerQuit = true;
+		PlatformBroadcastCond(workAvailable);
+		PlatformUnlockMutex(lock);
+		PlatformJoinThread(writer); // Writes whatever is still pending first
+		writer = NULL;
+	}
+	PlatformDestroyCond(writerIdle);
+	PlatformDestroyCond(workAvailable);
+	PlatformDestroyMutex(lock);
+	writerIdle = NULL;
+	workAvailable = NULL;
+	lock = NULL;
+}
+
+void WaitForSaveWriter(void)
+{
+	if (!writer) return;
+	PlatformLockMutex(lock);
+	while (hasPending || writerBusy)
+	{
+		PlatformWaitCond(writerIdle, lock);
+	}
+	PlatformUnlockMutex(lock);
+}
+
+bool QuickSave(const char* path)
+{
+	PROFILE_BEGIN("save", "QuickSave");
+	double start = PlatformGetTime();
+	bool ok = strlen(path) < SAVE_MAX_PATH;
+	if (ok) snprintf(staging->path, sizeof(staging->path), "%s", path);
+	for (int i = 0; i < SAVE_SECTION_COUNT && ok; i++)
+	{
+		SectionWriter sectionWriter = { staging->data[i], 0, false };
+		ok = serializers[i](&sectionWriter) && !sectionWriter.overflow;
+		staging->sizes[i] = sectionWriter.size;
+		staging->hashes[i] = HashBytes(staging->data[i], sectionWriter.size);
+	}
+	if (!ok)
+	{
+		DebugLog(LOG_WARNING, "Could not snapshot the game for <%s>", path);
+		PROFILE_END();
+		return false;
+	}
+
+	if (writer)
+	{
+		PlatformLockMutex(lock);
+		SaveSnapshot* swap = pending;
+		pending = staging;
+		staging = swap;
+		hasPending = true;
+		stats.saves++;
+		stats.lastSerializeMs = (PlatformGetTime() - start) * 1000.0;
+		PlatformSignalCond(workAvailable);
+		PlatformUnlockMutex(lock);
+	}
+	else
+	{
+		stats.saves++;
+		stats.lastSerializeMs = (PlatformGetTime() - start) * 1000.0;
+		double writeStart = PlatformGetTime();
+		WriteResult result = WriteSnapshot(staging);
+		RecordWrite(&result, PlatformGetTime() - writeStart);
+		ok = result.ok;
+	}
+	PROFILE_END();
+	return ok;
+}
+
+// ------ Loading ------
+
+static const char* GetSectionString(const unsigned char* section, uint32_t size, uint32_t offset)
+{
+	if (offset >= size || !memchr(section + offset, '\0', size - offset)) return NULL;
+	return (const char*)section + offset;
+}
+
+// Version 1 kept a name per slot and no counts: each slot becomes one of that item
+static bool LoadInventoryV1(const unsigned char* section, uint32_t size, Inventory* inventory)
+{
+	SaveInventorySectionV1 header;
+	if (size < sizeof(header)) return false;
+	memcpy(&header, section, sizeof(header));
+	if (header.maxItemCount <= 0 || header.maxItemCount > SAVE_MAX_ITEM_SLOTS || header.nameCount > SAVE_MAX_ITEM_SLOTS ||
+		(uint64_t)header.slotsOffset + header.maxItemCount * sizeof(uint32_t) > size ||
+		(uint64_t)header.namesOffset + header.nameCount * sizeof(uint32_t) > size)
+	{
+		return false;
+	}
+
+	ItemId items[SAVE_MAX_ITEM_SLOTS];
+	for (uint32_t i = 0; i < header.nameCount; i++)
+	{
+		uint32_t offset;
+		memcpy(&offset, section + header.namesOffset + i * sizeof(uint32_t), sizeof(offset));
+		const char* name = GetSectionString(section, size, offset);
+		if (!name) return false;
+		items[i] = FindItemByName(name);
+		if (items[i] == ITEM_NONE) DebugLog(LOG_WARNING, "Save has an unknown item <%s>, dropping it", name);
+	}
+
+	if (!InitInventory(inventory, header.maxItemCount)) return false;
+	for (int i = 0; i < header.maxItemCount; i++)
+	{
+		uint32_t index;
+		memcpy(&index, section + header.slotsOffset + i * sizeof(uint32_t), sizeof(index));
+		if (index == SAVE_EMPTY_SLOT) continue;
+		if (index >= header.nameCount)
+		{
+			FreeInventory(inventory);
+			return false;
+		}
+		AddItems(inventory, items[index], 1);
+	}
+	return true;
+}
+
+// Builds a new inventory from the section, so a bad one leaves the live inventory alone
+static bool LoadInventory(const unsigned char* section, uint32_t size, uint32_t version, Inventory* inventory)
+{
+	if (version == 1) return LoadInventoryV1(section, size, inventory);
+
+	SaveInventorySection header;
+	if (size < sizeof(header)) return false;
+	memcpy(&header, section, sizeof(header));
+	if (header.capacity <= 0 || header.capacity > SAVE_MAX_ITEM_SLOTS || header.keyCount > SAVE_MAX_ITEM_SLOTS ||
+		header.slotCount > (uint32_t)header.capacity ||
+		(uint64_t)header.keysOffset + header.keyCount * sizeof(uint32_t) > size ||
+		(uint64_t)header.slotsOffset + header.slotCount * sizeof(SaveInventorySlot) > size)
+	{
+		return false;
+	}
+
+	ItemId items[SAVE_MAX_ITEM_SLOTS];
+	for (uint32_t i = 0; i < header.keyCount; i++)
+	{
+		uint32_t offset;
+		memcpy(&offset, section + header.keysOffset + i * sizeof(uint32_t), sizeof(offset));
+		const char* key = GetSectionString(section, size, offset);
+		if (!key) return false;
+		items[i] = FindItem(key);
+		if (items[i] == ITEM_NONE) DebugLog(LOG_WARNING, "Save has an unknown item <%s>, dropping it", key);
+	}
+
+	if (!InitInventory(inventory, header.capacity)) return false;
+	for (uint32_t i = 0; i < header.slotCount; i++)
+	{
+		SaveInventorySlot saved;
+		memcpy(&saved, section + header.slotsOffset + i * sizeof(saved), sizeof(saved));
+		if (saved.slot >= header.capacity || saved.keyIndex >= header.keyCount || inventory->slots[saved.slot].item != ITEM_NONE)
+		{
+			FreeInventory(inventory);
+			return false;
+		}
+		if (items[saved.keyIndex] != ITEM_NONE) inventory->slots[saved.slot] = (InventorySlot){ items[saved.keyIndex], saved.count };
+	}
+	// Checks the counts against the item table
+	if (!RebuildInventory(inventory))
+	{
+		FreeInventory(inventory);
+		return false;
+	}
+	return true;
+}
+
+// Everything is validated before the first field of the game is touched
+static bool ApplySave(const unsigned char* data, const SaveFooter* footer, const char* path)
+{
+	const unsigned char* sections[SAVE_SECTION_COUNT];
+	for (int i = 0; i < SAVE_SECTION_COUNT; i++)
+	{
+		const SaveSectionEntry* entry = &footer->sections[i];
+		if (entry->offset == 0 || entry->version < oldestSectionVersions[i] || entry->version > sectionVersions[i])
+		{
+			DebugLog(LOG_WARNING, "Save <%s> is missing section %d or has an unsupported version of it", path, i);
+			return false;
+		}
+		sections[i] = data + entry->offset;
+	}
+
+	SavePlayerSection player;
+	SaveCharacterSection character;
+	SaveHudSection hud;
+	if (footer->sections[SAVE_SECTION_PLAYER].size < sizeof(player) ||
+		footer->sections[SAVE_SECTION_CHARACTER].size < sizeof(character) ||
+		footer->sections[SAVE_SECTION_HUD].size < sizeof(hud))
+	{
+		return false;
+	}
+	memcpy(&player, sections[SAVE_SECTION_PLAYER], sizeof(player));
+	memcpy(&character, sections[SAVE_SECTION_CHARACTER], sizeof(character));
+	memcpy(&hud, sections[SAVE_SECTION_HUD], sizeof(hud));
+
+	Scene* scene = GetFocusScene(globalSceneStack);
+	if (!scene || (int32_t)scene->id != player.sceneId)
+	{
+		DebugLog(LOG_WARNING, "Save <%s> was made in another scene, not loading it here", path);
+		return false;
+	}
+	EntityWorld* world = GetEntityWorld();
+	int index = GetEntityIndex(world, GetPlayer()->entity);
+	const char* name = GetSectionString(sections[SAVE_SECTION_CHARACTER], footer->sections[SAVE_SECTION_CHARACTER].size, character.nameOffset);
+	if (index < 0 || !name) return false;
+
+	const SaveSectionEntry* inventoryEntry = &footer->sections[SAVE_SECTION_INVENTORY];
+	Inventory inventory;
+	if (!LoadInventory(sections[SAVE_SECTION_INVENTORY], inventoryEntry->size, inventoryEntry->version, &inventory)) return false;
+
+	// Snap, do not interpolate from where the player was
+	world->posX[index] = world->prevX[index] = player.x;
+	world->posY[index] = world->prevY[index] = player.y;
+	world->direction[index] = player.direction;
+
+	Player_2* playerData = GetPlayerData();
+	snprintf(playerData->character.charName, CHARACTER_NAME_MAX, "%s", name);
+	playerData->character.charHeight = character.height;
+	playerData->character.charWeight = character.weight;
+	*GetPlayerAttributes() = (Attributes){ character.strength, character.charisma, character.wisdom,
+		character.intelligence, character.dexterity, character.vitality };
+	FreeInventory(&playerData->inv);
+	playerData->inv = inventory;
+
+	top_bar_context.gold = hud.gold;
+	top_bar_context.hp_percentage = hud.hpPercentage;
+	SetGameMinutes(hud.minutes);
+	return true;
+}
+
+bool LoadSave(const char* path)
+{
+	WaitForSaveWriter();
+	PROFILE_BEGIN("save", "LoadSave");
+	double start = PlatformGetTime();
+
+	const void* data = NULL;
+	size_t size = 0;
+	PlatformMappedFile* file = PlatformMapFile(path, &data, &size);
+	if (!file)
+	{
+		DebugLog(LOG_WARNING, "No save at <%s>", path);
+		PROFILE_END();
+		return false;
+	}
+
+	SaveFooter footer;
+	bool ok = FindFooter((const unsigned char*)data, size, &footer);
+	if (!ok) DebugLog(LOG_WARNING, "Save <%s> is damaged or from another version", path);
+	ok = ok && ApplySave((const unsigned char*)data, &footer, path);
+	PlatformUnmapFile(file);
+
+	stats.lastLoadMs = (PlatformGetTime() - start) * 1000.0;
+	if (ok) DebugLog(LOG_INFO, "Loaded <%s> (save %u) in %.3f ms", path, footer.generation, stats.lastLoadMs);
+	PROFILE_END();
+	return ok;
+}
+
+SaveStats GetSaveStats(void)
+{
+	if (!lock) return stats;
+	PlatformLockMutex(lock);
+	SaveStats copy = stats;
+	PlatformUnlockMutex(lock);
+	return copy;
+}
@@ -0,0 +1,135 @@
+#include "scene.h"
+#include "game_alloc.h"
+#include "logger.h"
+
+SceneStack* globalSceneStack;
+
+SceneStack* InitSceneStack() {
+	SceneStack* stack = (SceneStack*)GameAlloc(sizeof(SceneStack));
+	if (stack)
+	{
+		stack->scene_count = 0;
+		stack->top = -1;
+		stack->updateFrom = 0;
+		stack->renderFrom = 0;
+		stack->focus = -1;
+		stack->version = 0;
+		return stack;
+	}
+	else if (stack == NULL)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate memory for SceneStack");
+		return NULL;
+	}
+	return NULL;
+}
+
+static void ComputeSceneLayers(SceneStack* stack)
+{
+	stack->updateFrom = 0;
+	stack->renderFrom = 0;
+	stack->focus = -1;
+	for (int i = stack->top; i >= 0; i--)
+	{
+		unsigned int flags = stack->scenes[i]->flags;
+		if (stack->focus < 0 && !(flags & SCENE_OVERLAY)) stack->focus = i;
+		if (flags & SCENE_BLOCKS_UPDATE && stack->updateFrom == 0) stack->updateFrom = i;
+		if (flags & SCENE_BLOCKS_RENDER && stack->renderFrom == 0) stack->renderFrom = i;
+	}
+	stack->version++;
+}
+
+void PushScene(SceneStack* stack, Scene* scene)
+{
+	if (stack->scene_count < MAX_SCENES)
+	{
+		DebugLog(LOG_DEBUG, "Pushing scene ...%d ; %d", stack->top, stack->scene_count);
+		stack->top++;
+		stack->scenes[stack->top] = scene;
+		stack->scene_count++;
+		ComputeSceneLayers(stack);
+		DebugLog(LOG_INFO, "Pushed scene: <%s> | Current Scene Count: %d, Top index: %d", scene->scene_name, stack->scene_count, stack->top);
+		LogSceneResidency(stack);
+		PrefetchAssets(scene->successorAssets);
+	}
+}
+
+void PopScene(SceneStack* stack)
+{
+	if (stack->scene_count > 0)
+	{
+		Scene* scene = stack->scenes[stack->top];
+		if (scene->flags & SCENE_PERSISTENT)
+		{
+			DebugLog(LOG_WARNING, "Scene <%s> cannot be popped!", scene->scene_name);
+			return;
+		}
+		DebugLog(LOG_INFO, "Popping scene: <%s>", scene->scene_name);
+		stack->top--;
+		stack->scene_count--;
+		ComputeSceneLayers(stack);
+		if (scene->Free)
+		{
+			DebugLog(LOG_INFO, "Freeing scene resources for <%s>", scene->scene_name);
+			FreeScene(scene);
+		}
+		// Its assets stay resident until the VRAM budget needs the room
+		DebugLog(LOG_INFO, "<%s> leaves %.2f MB of textures cached", scene->scene_name, GetAssetScopeBytes(scene->id) / (1024.0 * 1024.0));
+	}
+	else
+	{
+		DebugLog(LOG_ERROR, "Scene Stack is empty! Current Scene Count: %d", stack->scene_count);
+	}
+}
+
+Scene* GetCurrentScene(SceneStack* stack)
+{
+	if (stack->scene_count > 0)
+	{
+		return stack->scenes[stack->top];
+	}
+	return NULL;
+}
+
+Scene* GetFocusScene(SceneStack* stack)
+{
+	return stack->focus >= 0 ? stack->scenes[stack->focus] : NULL;
+}
+
+void UpdateScene(Scene* scene)
+{
+	PROFILE_BEGIN("update", scene->scene_name);
+	scene->Update(scene->ctx);
+	PROFILE_END();
+}
+
+void RenderScene(Scene* scene)
+{
+	PROFILE_BEGIN("render", scene->scene_name);
+	scene->Render(scene->ctx);
+	PROFILE_END();
+}
+
+void FreeScene(Scene* scene)
+{
+	PROFILE_BEGIN("free", scene->scene_name);
+	scene->Free(scene->ctx);
+	PROFILE_END();
+}
+
+Scene* EndSceneLoad(Scene* scene)
+{
+	EndAssetScope(scene ? (int)scene->id : -1);
+	PROFILE_END_AS(scene ? scene->scene_name : NULL);
+	return scene;
+}
+
+void LogSceneResidency(const SceneStack* stack)
+{
+	LogAssetCacheStats();
+	for (int i = 0; i <= stack->top; i++)
+	{
+		const Scene* scene = stack->scenes[i];
+		DebugLog(LOG_INFO, "    <%s>: %.2f MB", scene->scene_name, GetAssetScopeBytes(scene->id) / (1024.0 * 1024.0));
+	}
+}
@@ -0,0 +1,558 @@
+#include "scenes.h"
+#include "game.h"
+#include "asset_cache.h"
+#include "input.h"
+#include "simulation.h"
+#include "sprite_batch.h"
+#include "spatial_hash.h"
+#include <stdio.h>
+#include <math.h>
+
+TitleScreenContext title_screen_context = { 0 };
+Scene title_scene = { 0 };
+BaseSceneContext base_scene_context = { 0 };
+Scene base_scene = { 0 };
+MainMenuContext main_menu_context = { 0 };
+Scene main_menu_scene = { 0 };
+CeliseCastleContext celise_castle_context = { 0 };
+Scene prologue_scene = { 0 };
+TopBarContext top_bar_context = { 0 };
+Scene top_bar_scene = { 0 };
+
+// ------------------- Scene Asset Manifests -------------------
+
+// The background is handed over from the title screen at screen size (ScreenTexture)
+static const char* mainMenuTextures[] = { "logo.png", "ng.png", "ng_hover.png" };
+static const AssetManifest mainMenuAssets = { mainMenuTextures, 3, NULL, 0 };
+
+static const char* castleTilePaths[] = { "wall.png", "floor.png", "carpet_red.png" };
+static const AtlasDesc castleTiles = { "castle_tiles", castleTilePaths, 3 };
+static const AtlasDesc* castleAtlases[] = { &castleTiles };
+static const char* castleTextures[] = { "interact_icon.png" };
+static const AssetManifest castleAssets = { castleTextures, 1, NULL, 0, castleAtlases, 1 };
+
+// -------------------- Base Scene ---------------------
+
+void UpdateBaseScene(void* ctx);
+void RenderBaseScene(void* ctx);
+void UnloadBaseScene(void* ctx);
+
+Scene* CreateBaseScene(BaseSceneContext* context, Scene* scene)
+{
+	context->dummy = 1;
+	scene->Update = UpdateBaseScene;
+	scene->Render = RenderBaseScene;
+	scene->Free = UnloadBaseScene;
+	scene->id = SCENE_BASE;
+	scene->flags = SCENE_BLOCKS_UPDATE | SCENE_BLOCKS_RENDER | SCENE_PERSISTENT;
+	scene->scene_name = "base_scene";
+	scene->ctx = context;
+	return scene;
+}
+
+void UpdateBaseScene(void* ctx)
+{
+	BaseSceneContext* context = (BaseSceneContext*)ctx;
+	if (GetInput()->anyKey)
+	{
+		PopScene(globalSceneStack);
+	}
+}
+
+void RenderBaseScene(void* ctx)
+{
+	ClearFrame(RAYWHITE);
+	DrawText("Null Scene", 10, 10, 20, DARKGRAY);
+}
+
+void UnloadBaseScene(void* ctx)
+{
+	// No resources to unload in this example
+}
+
+// ------------------- Title Screen Scene ------------------
+
+void UpdateTitleScreen(void* ctx);
+void RenderTitleScreen(void* ctx);
+void UnloadTitleScreen(void* ctx);
+
+Scene* CreateTitleScreenScene(TitleScreenContext* context, Scene* scene)
+{
+	context->wFrameCount = 0;
+	context->logo = AcquireTexture("logo.png");
+	AcquireScreenTexture(&context->bg, "background.png");
+	context->message = "> Press ENTER or any key to start <";
+	context->scene_font = AcquireTextFont("DalelandsUncial-BOpn.ttf", 32, false);
+
+	scene->Update = UpdateTitleScreen;
+	scene->Render = RenderTitleScreen;
+	scene->Free = UnloadTitleScreen;
+	scene->id = SCENE_TITLE_SCREEN;
+	scene->flags = SCENE_BLOCKS_UPDATE | SCENE_BLOCKS_RENDER;
+	scene->scene_name = "title_screen";
+	scene->successorAssets = &mainMenuAssets;
+	scene->ctx = context;
+
+	return scene;
+
+}
+
+void UpdateTitleScreen(void* ctx)
+{
+	TitleScreenContext* context = (TitleScreenContext*)ctx;
+
+	context->wFrameCount++;
+	if (GetInput()->anyKey)
+	{
+		PopScene(globalSceneStack); // Remove the title screen
+		PushScene(globalSceneStack, LoadScene(CreateMainMenuScene(&main_menu_context, &main_menu_scene))); // Push the main menu scene
+	}
+}
+
+void RenderTitleScreen(void* ctx)
+{
+	TitleScreenContext* context = (TitleScreenContext*)ctx;
+
+	// Queued before the clear, which it usually makes redundant
+	UpdateScreenTexture(&context->bg);
+	BatchScreenTexture(&context->bg, WHITE);
+	ClearFrame(BLACK);
+
+	Rectangle logoRect = {
+		GetScreenWidth() / 2 - context->logo.width / 2,
+		GetScreenHeight() / 2 - context->logo.height / 2 - 50,
+		context->logo.width,
+		context->logo.height
+	};
+	BatchSprite(context->logo, (Rectangle){ 0, 0, context->logo.width, context->logo.height }, logoRect, SPRITE_LAYER_HUD, WHITE);
+
+	// Laid out once and then served from the layout cache
+	const TextLayout* message = LayoutText(&context->scene_font, context->message, 32, 2);
+	if (message)
+	{
+		Vector2 textPos = { GetScreenWidth()/2.0f - message->size.x/2.0f, GetScreenHeight() / 2.0f + context->logo.height / 2.0f + 20.0f}; // 20.0f is spacing between logo and text
+		BatchTextLayout(message, textPos, SPRITE_LAYER_HUD, LIGHTGRAY);
+	}
+}
+
+void UnloadTitleScreen(void* ctx)
+{
+	TitleScreenContext* context = (TitleScreenContext*)ctx;
+
+	ReleaseTexture(context->logo);
+	ReleaseScreenTexture(&context->bg);
+	ReleaseTextFont(context->scene_font);
+}
+
+// -------------------- Main Menu --------------------------
+
+void UpdateMainMenu(void* ctx);
+void RenderMainMenu(void* ctx);
+void UnloadMainMenu(void* ctx);
+
+Scene* CreateMainMenuScene(MainMenuContext* context, Scene* scene)
+{
+	context->wFrameCount = 0;
+	context->logo = AcquireTexture("logo.png");
+	AcquireScreenTexture(&context->bg, "background.png");
+	context->logoY = GetGameHeight()/2.0f; // Start off-screen
+	context->prevLogoY = context->logoY;
+	context->targetLogoY = GetGameHeight() / 4.0f; // Target position
+	context->logoSettled = false;
+	context->buttonSelected = false;
+	context->newGameButton = AcquireTexture("ng.png");
+	context->newGameButtonHover = AcquireTexture("ng_hover.png");
+
+	scene->Update = UpdateMainMenu;
+	scene->Render = RenderMainMenu;
+	scene->Free = UnloadMainMenu;
+	scene->id = SCENE_MAIN_MENU;
+	scene->flags = SCENE_BLOCKS_UPDATE | SCENE_BLOCKS_RENDER;
+	scene->scene_name = "main_menu";
+	scene->successorAssets = &castleAssets;
+	scene->ctx = context;
+
+	return scene;
+
+}
+
+// Button placement depends on where the logo is, so Update and Render share it
+static Rectangle MainMenuButtonRect(MainMenuContext* context, float logoY)
+{
+	int buttonWidth = context->newGameButton.width;
+	int buttonHeight = context->newGameButton.height;
+	int startY = (int)logoY + context->logo.height / 2 + 40; // Start below logo
+	return (Rectangle){ GetGameWidth() / 2 - buttonWidth/2, startY, buttonWidth, buttonHeight };
+}
+
+void UpdateMainMenu(void* ctx)
+{
+	MainMenuContext* context = (MainMenuContext*)ctx;
+	const InputState* input = GetInput();
+
+	// Smoothly interpolate logo upwards, 5% of the remaining distance per 60 Hz step
+	context->prevLogoY = context->logoY;
+	if (!context->logoSettled) {
+		float t = 1.0f - powf(0.95f, GetSimulationDelta() * 60.0f);
+		context->logoY += (context->targetLogoY - context->logoY) * t;
+
+		if (fabsf(context->logoY - context->targetLogoY) < 1.0f) {
+			context->logoY = context->targetLogoY;
+			context->logoSettled = true;
+		}
+	}
+
+	Rectangle newGameRect = MainMenuButtonRect(context, context->logoY);
+	if ( (CheckCollisionPointRec(input->pointer, newGameRect)) || input->pressed[ACTION_NAV_DOWN] || context->buttonSelected) {
+		context->buttonSelected = true;
+		if (input->pressed[ACTION_CLICK] || input->pressed[ACTION_CONFIRM]) {
+			PopScene(globalSceneStack);
+			PushScene(globalSceneStack, LoadScene(CreateCastleScene(&celise_castle_context, &prologue_scene)));
+			PushScene(globalSceneStack, LoadScene(CreateTopBar(&top_bar_context, &top_bar_scene))); // HUD overlay for the castle
+		}
+	}
+}
+
+void RenderMainMenu(void* ctx)
+{
+	MainMenuContext* context = (MainMenuContext*)ctx;
+
+	UpdateScreenTexture(&context->bg);
+	BatchScreenTexture(&context->bg, WHITE);
+	ClearFrame(BLACK);
+
+	float logoY = context->prevLogoY + (context->logoY - context->prevLogoY) * GetRenderAlpha();
+
+	Rectangle logoRect = {
+		GetScreenWidth() / 2 - context->logo.width / 2,
+		(int)logoY - context->logo.height / 2,
+		context->logo.width,
+		context->logo.height
+	};
+	BatchSprite(context->logo, (Rectangle){ 0, 0, context->logo.width, context->logo.height }, logoRect, SPRITE_LAYER_HUD, WHITE);
+
+	// New Game Button
+	Rectangle newGameRect = MainMenuButtonRect(context, logoY);
+	Texture2D button = context->buttonSelected ? context->newGameButtonHover : context->newGameButton;
+	newGameRect.width = button.width;
+	newGameRect.height = button.height;
+	BatchSprite(button, (Rectangle){ 0, 0, button.width, button.height }, newGameRect, SPRITE_LAYER_HUD, WHITE);
+
+}
+
+void UnloadMainMenu(void* ctx)
+{
+	MainMenuContext* context = (MainMenuContext*)ctx;
+	ReleaseTexture(context->logo);
+	ReleaseScreenTexture(&context->bg);
+	ReleaseTexture(context->newGameButton);
+	ReleaseTexture(context->newGameButtonHover);
+}
+
+// ----- Prologue Scene
+
+void UpdateCastleScene(void* ctx);
+void RenderCastleScene(void* ctx);
+void UnloadCastleScene(void* ctx);
+
+// Tile types of castleTiles, in atlas order
+enum { TILE_WALL = 1, TILE_FLOOR, TILE_CARPET };
+
+#define CASTLE_WIDTH_TILES 42 // Floor tiles across the hall, about three screens
+#define INTERACT_RADIUS 160.0f // How close the player's centre must be to a trigger's centre
+
+// The hall is laid out in world units against a GAME_HEIGHT tall view: a strip of wall,
+// three rows of floor, and a carpet running along the front of the floor
+static void BuildCastleLevel(Tilemap* level)
+{
+	Vector2 wallSize = GetTileSize(level, TILE_WALL);
+	Vector2 floorSize = GetTileSize(level, TILE_FLOOR);
+	Vector2 carpetSize = GetTileSize(level, TILE_CARPET);
+	int wallTop = GAME_HEIGHT / 2 - (int)wallSize.y / 2 - 70;
+	int floorTop = GAME_HEIGHT / 2 + (int)wallSize.y / 2 - 70;
+	float hallWidth = floorSize.x * CASTLE_WIDTH_TILES;
+
+	int wallCount = wallSize.x > 0 ? (int)ceilf(hallWidth / wallSize.x) : 0;
+	TileLayer* wallLayer = AddTileLayer(level, (Vector2){ 0, wallTop }, wallSize.x, wallSize.y, wallCount, 1);
+	if (wallLayer) FillTiles(wallLayer, 0, 0, wallCount, 1, TILE_WALL);
+
+	TileLayer* floorLayer = AddTileLayer(level, (Vector2){ 0, floorTop }, floorSize.x, floorSize.y * 5 / 3, CASTLE_WIDTH_TILES, 3);
+	if (floorLayer) FillTiles(floorLayer, 0, 0, CASTLE_WIDTH_TILES, 3, TILE_FLOOR);
+
+	TileLayer* carpetLayer = AddTileLayer(level, (Vector2){ 0, floorTop + (int)carpetSize.y / 4 }, floorSize.x, carpetSize.y + 70, CASTLE_WIDTH_TILES, 1);
+	if (carpetLayer) FillTiles(carpetLayer, 0, 0, CASTLE_WIDTH_TILES, 1, TILE_CARPET);
+
+	BuildTilemap(level);
+}
+
+// Spots along the hall the player can interact with, as fractions of the hall width
+static const float interactSpots[] = { 0.2f, 0.5f, 0.8f };
+static const char* interactNames[] = { "portrait", "door", "chest" };
+
+static void SpawnInteractables(CeliseCastleContext* context, Rectangle hall)
+{
+	EntityWorld* world = GetEntityWorld();
+	context->interactableCount = 0;
+	for (int s = 0; s < 3; s++)
+	{
+		EntityId id = SpawnEntity(world, (Vector2){ hall.x + hall.width * interactSpots[s], 350 }, interactNames[s]);
+		int i = GetEntityIndex(world, id);
+		if (i < 0) continue;
+
+		// No texture: the frame size only serves as the trigger's bounds
+		world->frameWidth[i] = 120.0f;
+		world->frameHeight[i] = 220.0f;
+		world->flags[i] = ENTITY_FLAG_INTERACTABLE;
+		context->interactables[context->interactableCount++] = id;
+	}
+}
+
+Scene* CreateCastleScene(CeliseCastleContext* context, Scene* scene)
+{
+	context->wFrameCount = 0;
+	context->level = CreateTilemap(&castleTiles);
+	if (context->level) BuildCastleLevel(context->level);
+	context->sceneRendered = false;
+
+	Rectangle hall = context->level ? GetTilemapBounds(context->level) : (Rectangle){ 0, 0, GAME_WIDTH, GAME_HEIGHT };
+	Player* player = GetPlayer();
+	player->walkArea = hall;
+	// The hall is laid out against a GAME_HEIGHT tall view, so the camera only scrolls sideways
+	InitWorldCamera(&context->camera, (Rectangle){ hall.x, 0, hall.width, GAME_HEIGHT }, GetPlayerPosition(player));
+	SpawnInteractables(context, hall);
+	context->interactTarget = NULL_ENTITY;
+	context->interactIcon = AcquireTexture("interact_icon.png");
+	
+	scene->ctx = context;
+	scene->Update = UpdateCastleScene;
+	scene->Render = RenderCastleScene;
+	scene->Free = UnloadCastleScene;
+	scene->id = SCENE_CASTLE_PROLOGUE;
+	scene->flags = SCENE_BLOCKS_UPDATE | SCENE_BLOCKS_RENDER;
+	scene->scene_name = "celise_castle_prologue";
+	return scene;
+}
+
+// Nearest interactable whose centre is within reach of the player's, from the spatial
+// hash built at the end of the previous tick
+static EntityId FindInteractTarget(const Player* player)
+{
+	const EntityWorld* world = GetEntityWorld();
+	int p = GetEntityIndex(world, player->entity);
+	if (p < 0) return NULL_ENTITY;
+
+	Vector2 center = { world->posX[p] + world->frameWidth[p] * 0.5f, world->posY[p] + world->frameHeight[p] * 0.5f };
+	int nearby[16];
+	int found = QueryEntitiesInRadius(GetSpatialHash(), world, center, INTERACT_RADIUS, nearby, 16);
+	if (found > 16) found = 16;
+
+	EntityId target = NULL_ENTITY;
+	float best = INTERACT_RADIUS * INTERACT_RADIUS;
+	for (int n = 0; n < found; n++)
+	{
+		int i = nearby[n];
+		if (!(world->flags[i] & ENTITY_FLAG_INTERACTABLE)) continue;
+
+		float dx = world->posX[i] + world->frameWidth[i] * 0.5f - center.x;
+		float dy = world->posY[i] + world->frameHeight[i] * 0.5f - center.y;
+		if (dx * dx + dy * dy <= best)
+		{
+			best = dx * dx + dy * dy;
+			target = world->ids[i];
+		}
+	}
+	return target;
+}
+
+void UpdateCastleScene(void* ctx)
+{
+	CeliseCastleContext* context = (CeliseCastleContext*) ctx;
+	Player* player = GetPlayer();
+
+	UpdatePlayer(player, GetSimulationDelta());
+	context->interactTarget = FindInteractTarget(player);
+
+	// Follow the middle of the player's frame
+	Vector2 focus = GetPlayerPosition(player);
+	Vector2 size = GetPlayerSize(player);
+	focus.x += size.x * 0.5f;
+	focus.y += size.y * 0.5f;
+	UpdateWorldCamera(&context->camera, focus, GetSimulationDelta());
+
+	//if(context->sceneRendered)
+	//{
+	//	// For demonstration, pop the scene after rendering once
+	//	//PopScene(globalSceneStack);
+	//	//PushScene(globalSceneStack, CreateTopBar(&top_bar_context, &top_bar_scene));
+	//}
+}
+
+void RenderCastleScene(void* ctx)
+{
+	CeliseCastleContext* context = (CeliseCastleContext*)ctx;
+	Camera2D camera = GetRenderCamera(&context->camera, GetRenderAlpha());
+
+	ClearFrame(BLACK); // The hall does not cover the whole view
+
+	if (context->level)
+	{
+		BeginMode2D(camera);
+		DrawTilemap(context->level, GetCameraView(camera));
+		EndMode2D();
+		context->sceneRendered = true;
+	}
+
+	// Sprites are batched in screen space, so entities go through the camera by hand
+	EntityWorld* world = GetEntityWorld();
+	DrawVisibleEntities(world, GetSpatialHash(), camera, GetRenderAlpha());
+
+	int target = GetEntityIndex(world, context->interactTarget);
+	if (target >= 0 && context->interactIcon.id != 0)
+	{
+		float size = 48.0f;
+		Rectangle above = { world->posX[target] + (world->frameWidth[target] - size) * 0.5f, world->posY[target] - size - 8, size, size };
+		Rectangle source = { 0, 0, (float)context->interactIcon.width, (float)context->interactIcon.height };
+		BatchSprite(context->interactIcon, source, WorldToScreenRect(camera, above), SPRITE_LAYER_HUD, WHITE);
+	}
+}
+
+void UnloadCastleScene(void* ctx)
+{
+	CeliseCastleContext* context = (CeliseCastleContext*)ctx;
+
+	for (int i = 0; i < context->interactableCount; i++)
+	{
+		DespawnEntity(GetEntityWorld(), context->interactables[i]);
+	}
+	context->interactableCount = 0;
+	context->interactTarget = NULL_ENTITY;
+	ReleaseTexture(context->interactIcon);
+	GetPlayer()->walkArea = (Rectangle){ 0, 0, (float)GetGameWidth(), (float)GetGameHeight() };
+
+	FreeTilemap(context->level);
+	context->level = NULL;
+}
+
+// ------------------------- Top Bar ----------------------------
+
+void UpdateTopBar(void* ctx);
+void RenderTopBar(void* ctx);
+void UnloadTopBar(void* ctx);
+
+Scene* CreateTopBar(TopBarContext* context, Scene* scene)
+{
+	context->wFrameCount = 0;
+	context->atlas = AcquireAtlas(&spriteAtlas);
+	context->bg = GetAtlasRegion(context->atlas, "hud.png");
+	context->portrait_frame = GetAtlasRegion(context->atlas, "portrait_frame.png");
+	context->portrait = GetAtlasRegion(context->atlas, "portrait.png");
+	context->ui_frame = GetAtlasRegion(context->atlas, "ui_frame.png");
+	context->nameFont = AcquireTextFont("DalelandsUncial-BOpn.ttf", 24, false);
+	context->hudFont = AcquireTextFont("DalelandsUncial-BOpn.ttf", 20, false);
+	context->arena = CreateArena("top_bar", SCENE_ARENA_SIZE);
+	context->character_name = context->arena ? ArenaStrdup(context->arena, GetPlayerData()->character.charName) : NULL;
+	context->datetime = NULL;
+	context->gold = 0;
+
+	scene->Update = UpdateTopBar;
+	scene->Render = RenderTopBar;
+	scene->Free = UnloadTopBar;
+	scene->id = SCENE_TOP_BAR;
+	scene->flags = SCENE_OVERLAY;
+	scene->scene_name = "top_bar";
+	scene->ctx = context;
+	return scene;
+}
+
+void UpdateTopBar(void* ctx)
+{
+	TopBarContext* context = (TopBarContext*)ctx;
+}
+
+// The static frame of the bar, drawn straight into the frame layer
+static void DrawTopBarFrame(TopBarContext* context)
+{
+	Texture2D atlas = context->atlas->texture;
+	Vector2 origin = { 0, 0 };
+
+	// hud.png used to rely on texture repeat; atlas regions are tiled instead
+	for (int i = 0; i < 14; i++)
+	{
+		DrawTexturePro(atlas,
+			context->bg,
+			(Rectangle) {context->bg.width * i, 0, context->bg.width, context->bg.height},
+			origin,
+			0.0f,
+			WHITE);
+	}
+
+	DrawTexturePro(atlas,
+		context->portrait,
+		(Rectangle) {0, 0, context->portrait.width, context->portrait.height},
+		origin,
+		0.0f,
+		WHITE);
+
+	DrawTexturePro(atlas,
+		context->portrait_frame,
+		(Rectangle) {0, 0, context->portrait_frame.width, context->portrait_frame.height},
+		origin,
+		0.0f,
+		WHITE);
+
+	DrawTexturePro(atlas,
+		context->ui_frame,
+		(Rectangle) {0, 0, context->ui_frame.width, context->ui_frame.height},
+		origin,
+		0.0f,
+		WHITE);
+
+	DrawTexturePro(atlas,
+		context->ui_frame,
+		(Rectangle) {context->ui_frame.width + 10, 0, context->ui_frame.width + 100, context->ui_frame.height},
+		origin,
+		0.0f,
+		WHITE);
+}
+
+void RenderTopBar(void* ctx)
+{
+	TopBarContext* context = (TopBarContext*)ctx;
+
+	float height = fmaxf(fmaxf(context->bg.height, context->portrait.height), fmaxf(context->portrait_frame.height, context->ui_frame.height));
+	if (height <= 0) return; // Atlas failed to load
+	int inputs[] = { GetScreenWidth(), (int)context->atlas->texture.id };
+	if (BeginCachedLayer(&context->frameLayer, GetScreenWidth(), (int)height, HashLayerInputs(0, inputs, sizeof(inputs))))
+	{
+		DrawTopBarFrame(context);
+		EndCachedLayer(&context->frameLayer);
+	}
+
+	// One quad for the whole frame; dynamic HUD elements go on top of it
+	BatchSprite(context->frameLayer.target.texture,
+		GetCachedLayerSource(&context->frameLayer),
+		(Rectangle) {0, 0, context->frameLayer.target.texture.width, context->frameLayer.target.texture.height},
+		SPRITE_LAYER_HUD,
+		WHITE);
+
+	long long minutes = GetGameMinutes();
+	Arena* frame = GetFrameArena();
+	context->datetime = ArenaPrintf(frame, "Day %lld  %02lld:%02lld", minutes / (24 * 60) + 1, minutes / 60 % 24, minutes % 60);
+	float textX = context->portrait_frame.width + 10;
+	BatchText(&context->nameFont, context->character_name, (Vector2) { textX, 12 }, 24, 1, SPRITE_LAYER_HUD, WHITE);
+	BatchText(&context->hudFont, context->datetime, (Vector2) { context->ui_frame.width + 20, 12 }, 20, 1, SPRITE_LAYER_HUD, WHITE);
+	BatchText(&context->hudFont, ArenaPrintf(frame, "%d gold", context->gold), (Vector2) { context->ui_frame.width + 20, 40 }, 20, 1, SPRITE_LAYER_HUD, GOLD);
+}
+
+void UnloadTopBar(void* ctx)
+{
+	TopBarContext* context = (TopBarContext*)ctx;
+
+	ReleaseAtlas(context->atlas);
+	ReleaseTextFont(context->nameFont);
+	ReleaseTextFont(context->hudFont);
+	UnloadCachedLayer(&context->frameLayer);
+	DestroyArena(context->arena);
+	context->arena = NULL;
+	context->character_name = NULL;
+}
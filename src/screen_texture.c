@@ -0,0 +1,69 @@
+#include "screen_texture.h"
+#include "sprite_batch.h"
+#include "asset_cache.h"
+
+void AcquireScreenTexture(ScreenTexture* screen, const char* path)
+{
+	*screen = (ScreenTexture){ 0 };
+	screen->path = path;
+	int width = GetRenderWidth();
+	int height = GetRenderHeight();
+	if (width > 0 && height > 0 && IsTextureReady(path, width, height))
+	{
+		screen->texture = AcquireTextureSized(path, width, height);
+		screen->width = width;
+		screen->height = height;
+		return;
+	}
+	screen->texture = AcquireTexture(path); // Often decoded already, the variant is not
+	UpdateScreenTexture(screen);
+}
+
+void UpdateScreenTexture(ScreenTexture* screen)
+{
+	if (screen->pendingWidth > 0)
+	{
+		if (!IsTextureReady(screen->path, screen->pendingWidth, screen->pendingHeight)) return;
+		Texture2D variant = AcquireTextureSized(screen->path, screen->pendingWidth, screen->pendingHeight);
+		ReleaseTexture(screen->texture); // Stays cached, a resize back finds it ready
+		screen->texture = variant;
+		screen->width = screen->pendingWidth;
+		screen->height = screen->pendingHeight;
+		screen->pendingWidth = 0;
+		screen->pendingHeight = 0;
+	}
+
+	// One variant in flight at a time: a window being dragged only scales the sizes it
+	// stops at long enough
+	int width = GetRenderWidth();
+	int height = GetRenderHeight();
+	if (width <= 0 || height <= 0 || (width == screen->width && height == screen->height)) return;
+	if (PrefetchTextureSized(screen->path, width, height))
+	{
+		screen->pendingWidth = width;
+		screen->pendingHeight = height;
+	}
+	else
+	{
+		// No room in the cache: keep stretching what we have at this size
+		screen->width = width;
+		screen->height = height;
+	}
+}
+
+void BatchScreenTexture(const ScreenTexture* screen, Color tint)
+{
+	BatchSprite(screen->texture,
+		(Rectangle){ 0, 0, (float)screen->texture.width, (float)screen->texture.height },
+		(Rectangle){ 0, 0, (float)GetScreenWidth(), (float)GetScreenHeight() },
+		SPRITE_LAYER_BACKGROUND,
+		tint);
+}
+
+void ReleaseScreenTexture(ScreenTexture* screen)
+{
+	// A variant still on its way stays prefetched: the next scene with this background
+	// usually wants the same size
+	ReleaseTexture(screen->texture);
+	*screen = (ScreenTexture){ 0 };
+}
@@ -0,0 +1,84 @@
+#include "simulation.h"
+#include "platform.h"
+
+typedef struct {
+	double tickDelta;
+	double accumulator;
+	double previousTime;
+	float alpha;
+	long long tick;
+	// Simulated time is counted from the last rate change, so it never jumps when the rate does
+	int ticksPerSecond;
+	long long rateTick;
+	double rateSeconds;
+} SimulationClock;
+
+static SimulationClock simClock = { 1.0 / SIM_TICK_RATE, 0.0, 0.0, 0.0f, 0, SIM_TICK_RATE, 0, 0.0 };
+
+void InitSimulationClock(int ticksPerSecond)
+{
+	SetSimulationRate(ticksPerSecond);
+	simClock.accumulator = 0.0;
+	simClock.previousTime = PlatformGetTime();
+	simClock.alpha = 0.0f;
+	simClock.tick = 0;
+	simClock.rateTick = 0;
+	simClock.rateSeconds = 0.0;
+}
+
+void SetSimulationRate(int ticksPerSecond)
+{
+	if (ticksPerSecond <= 0) ticksPerSecond = SIM_TICK_RATE;
+	simClock.rateSeconds = GetSimulationTime();
+	simClock.rateTick = simClock.tick;
+	simClock.ticksPerSecond = ticksPerSecond;
+	simClock.tickDelta = 1.0 / ticksPerSecond;
+}
+
+int AdvanceSimulationClock(void)
+{
+	double now = PlatformGetTime();
+	double frameTime = now - simClock.previousTime;
+	simClock.previousTime = now;
+	if (frameTime > SIM_MAX_FRAME_TIME)
+	{
+		frameTime = SIM_MAX_FRAME_TIME;
+	}
+
+	simClock.accumulator += frameTime;
+	int ticks = 0;
+	while (simClock.accumulator >= simClock.tickDelta)
+	{
+		simClock.accumulator -= simClock.tickDelta;
+		ticks++;
+	}
+	simClock.tick += ticks;
+	simClock.alpha = (float)(simClock.accumulator / simClock.tickDelta);
+	return ticks;
+}
+
+void StepSimulationClock(void)
+{
+	simClock.tick++;
+	simClock.alpha = 0.0f;
+}
+
+float GetSimulationDelta(void)
+{
+	return (float)simClock.tickDelta;
+}
+
+float GetRenderAlpha(void)
+{
+	return simClock.alpha;
+}
+
+long long GetSimulationTick(void)
+{
+	return simClock.tick;
+}
+
+double GetSimulationTime(void)
+{
+	return simClock.rateSeconds + (double)(simClock.tick - simClock.rateTick) / simClock.ticksPerSecond;
+}
@@ -0,0 +1,135 @@
+#include "spatial_hash.h"
+#include "game_alloc.h"
+#include "logger.h"
+#include <math.h>
+#include <string.h>
+
+static unsigned int HashCell(int x, int y)
+{
+	return ((unsigned int)x * 73856093u ^ (unsigned int)y * 19349663u) & (SPATIAL_BUCKETS - 1);
+}
+
+SpatialHash* CreateSpatialHash(int capacity, float cellSize)
+{
+	SpatialHash* hash = (SpatialHash*)GameAlloc(sizeof(SpatialHash));
+	if (!hash)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate memory for SpatialHash");
+		return NULL;
+	}
+	memset(hash, 0, sizeof(SpatialHash));
+	hash->cellSize = cellSize;
+	hash->capacity = capacity;
+	hash->next = (int*)GameAlloc(sizeof(int) * capacity);
+	hash->cellX = (int*)GameAlloc(sizeof(int) * capacity);
+	hash->cellY = (int*)GameAlloc(sizeof(int) * capacity);
+	for (int i = 0; i < SPATIAL_BUCKETS; i++) hash->heads[i] = -1;
+	return hash;
+}
+
+void DestroySpatialHash(SpatialHash* hash)
+{
+	if (!hash) return;
+	GameFree(hash->next);
+	GameFree(hash->cellX);
+	GameFree(hash->cellY);
+	GameFree(hash);
+}
+
+void RebuildSpatialHash(SpatialHash* hash, const EntityWorld* world)
+{
+	for (int i = 0; i < SPATIAL_BUCKETS; i++) hash->heads[i] = -1;
+
+	int count = world->count < hash->capacity ? world->count : hash->capacity;
+	float maxExtent = 0.0f;
+	for (int i = 0; i < count; i++)
+	{
+		int x = (int)floorf(world->posX[i] / hash->cellSize);
+		int y = (int)floorf(world->posY[i] / hash->cellSize);
+		unsigned int bucket = HashCell(x, y);
+		hash->cellX[i] = x;
+		hash->cellY[i] = y;
+		hash->next[i] = hash->heads[bucket];
+		hash->heads[bucket] = i;
+
+		if (world->frameWidth[i] > maxExtent) maxExtent = world->frameWidth[i];
+		if (world->frameHeight[i] > maxExtent) maxExtent = world->frameHeight[i];
+	}
+	hash->count = count;
+	hash->maxExtent = maxExtent;
+}
+
+static bool OverlapsRect(const EntityWorld* world, int i, Rectangle rect)
+{
+	return world->posX[i] <= rect.x + rect.width && world->posX[i] + world->frameWidth[i] >= rect.x &&
+		world->posY[i] <= rect.y + rect.height && world->posY[i] + world->frameHeight[i] >= rect.y;
+}
+
+static bool WithinRadius(const EntityWorld* world, int i, Vector2 center, float radius)
+{
+	float dx = world->posX[i] + world->frameWidth[i] * 0.5f - center.x;
+	float dy = world->posY[i] + world->frameHeight[i] * 0.5f - center.y;
+	return dx * dx + dy * dy <= radius * radius;
+}
+
+typedef struct {
+	Rectangle rect;
+	Vector2 center;
+	float radius;
+	bool isRadius;
+} SpatialQuery;
+
+static int RunQuery(const SpatialHash* hash, const EntityWorld* world, const SpatialQuery* query, Rectangle area, int* results, int maxResults)
+{
+	int found = 0;
+	// Entities are filed by their top-left corner, so anything reaching into the area
+	// from up to maxExtent above or to the left must be visited as well
+	int x0 = (int)floorf((area.x - hash->maxExtent) / hash->cellSize);
+	int y0 = (int)floorf((area.y - hash->maxExtent) / hash->cellSize);
+	int x1 = (int)floorf((area.x + area.width) / hash->cellSize);
+	int y1 = (int)floorf((area.y + area.height) / hash->cellSize);
+
+	long long cells = (long long)(x1 - x0 + 1) * (y1 - y0 + 1);
+	if (cells > hash->count)
+	{
+		// Covering more cells than there are entities; a straight scan is cheaper
+		for (int i = 0; i < hash->count; i++)
+		{
+			bool hit = query->isRadius ? WithinRadius(world, i, query->center, query->radius) : OverlapsRect(world, i, query->rect);
+			if (!hit) continue;
+			if (found < maxResults) results[found] = i;
+			found++;
+		}
+		return found;
+	}
+
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			for (int i = hash->heads[HashCell(x, y)]; i >= 0; i = hash->next[i])
+			{
+				// Buckets are shared between distant cells; only take entities filed under this one
+				if (hash->cellX[i] != x || hash->cellY[i] != y) continue;
+				bool hit = query->isRadius ? WithinRadius(world, i, query->center, query->radius) : OverlapsRect(world, i, query->rect);
+				if (!hit) continue;
+				if (found < maxResults) results[found] = i;
+				found++;
+			}
+		}
+	}
+	return found;
+}
+
+int QueryEntitiesInRect(const SpatialHash* hash, const EntityWorld* world, Rectangle rect, int* results, int maxResults)
+{
+	SpatialQuery query = { rect, { 0, 0 }, 0.0f, false };
+	return RunQuery(hash, world, &query, rect, results, maxResults);
+}
+
+int QueryEntitiesInRadius(const SpatialHash* hash, const EntityWorld* world, Vector2 center, float radius, int* results, int maxResults)
+{
+	SpatialQuery query = { { 0 }, center, radius, true };
+	Rectangle area = { center.x - radius, center.y - radius, radius * 2, radius * 2 };
+	return RunQuery(hash, world, &query, area, results, maxResults);
+}
@@ -0,0 +1,259 @@
+#include "sprite_batch.h"
+#include "asset_cache.h"
+#include "logger.h"
+#include "rlgl.h"
+#include <stdlib.h>
+
+typedef struct {
+	Texture2D texture;
+	Rectangle source;
+	Rectangle dest;
+	Color tint;
+	int layer;
+	int sequence; // Submission order, keeps the sort stable
+	const TextLayout* layout; // Set for text; dest.x/y is the position
+	bool opaque; // Filled in by EndSpriteBatch()
+} SpriteCommand;
+
+static SpriteCommand commands[MAX_BATCH_SPRITES];
+static int commandCount = 0;
+static SpriteBatchStats lastStats = { 0 };
+static DrawView drawView = DRAW_VIEW_NORMAL;
+
+static int CompareSprites(const void* a, const void* b)
+{
+	const SpriteCommand* left = (const SpriteCommand*)a;
+	const SpriteCommand* right = (const SpriteCommand*)b;
+	if (left->layer != right->layer) return left->layer < right->layer ? -1 : 1;
+	if (left->texture.id != right->texture.id) return left->texture.id < right->texture.id ? -1 : 1;
+	return left->sequence - right->sequence;
+}
+
+void BeginSpriteBatch(void)
+{
+	commandCount = 0;
+}
+
+void BatchSprite(Texture2D texture, Rectangle source, Rectangle dest, int layer, Color tint)
+{
+	if (commandCount == MAX_BATCH_SPRITES)
+	{
+		DebugLog(LOG_WARNING, "Sprite batch full (%d sprites), dropping sprite", MAX_BATCH_SPRITES);
+		return;
+	}
+	commands[commandCount] = (SpriteCommand){ texture, source, dest, tint, layer, commandCount, NULL, false };
+	commandCount++;
+}
+
+void BatchTextLayout(const TextLayout* layout, Vector2 position, int layer, Color tint)
+{
+	if (!layout) return;
+	if (commandCount == MAX_BATCH_SPRITES)
+	{
+		DebugLog(LOG_WARNING, "Sprite batch full (%d sprites), dropping text", MAX_BATCH_SPRITES);
+		return;
+	}
+	commands[commandCount] = (SpriteCommand){ layout->texture, { 0 }, { position.x, position.y, 0, 0 }, tint, layer, commandCount, layout, false };
+	commandCount++;
+}
+
+void BatchText(const TextFont* font, const char* text, Vector2 position, float fontSize, float spacing, int layer, Color tint)
+{
+	BatchTextLayout(LayoutText(font, text, fontSize, spacing), position, layer, tint);
+}
+
+// Atlas regions cannot rely on texture wrapping, so repeat the region as separate quads
+void BatchSpriteTiled(Texture2D texture, Rectangle source, Rectangle dest, int layer, Color tint)
+{
+	if (source.width <= 0 || source.height <= 0) return;
+
+	for (float y = 0; y < dest.height; y += source.height)
+	{
+		float h = (dest.height - y < source.height) ? dest.height - y : source.height;
+		for (float x = 0; x < dest.width; x += source.width)
+		{
+			float w = (dest.width - x < source.width) ? dest.width - x : source.width;
+			BatchSprite(texture,
+				(Rectangle){ source.x, source.y, w, h },
+				(Rectangle){ dest.x + x, dest.y + y, w, h },
+				layer, tint);
+		}
+	}
+}
+
+// Looked up once per texture: opaque as a whole, or an atlas whose regions may be
+typedef struct {
+	bool opaque;
+	const TextureAtlas* atlas;
+} TextureOpacity;
+
+static TextureOpacity GetTextureOpacity(Texture2D texture)
+{
+	TextureOpacity opacity = { false, NULL };
+	if (drawView == DRAW_VIEW_OVERDRAW_BLENDED) return opacity;
+	opacity.opaque = IsTextureOpaque(texture);
+	if (!opacity.opaque) opacity.atlas = FindTextureAtlas(texture);
+	return opacity;
+}
+
+static bool IsCommandOpaque(const SpriteCommand* command, TextureOpacity opacity)
+{
+	if (command->layout || command->tint.a != 255) return false;
+	return opacity.opaque || (opacity.atlas && IsAtlasSourceOpaque(opacity.atlas, command->source));
+}
+
+// Sorted position i drawn at depth: later in the back-to-front order is nearer
+static float CommandDepth(int i)
+{
+	return SPRITE_DEPTH_FAR - SPRITE_DEPTH_FAR * (float)(i + 1) / (float)(MAX_BATCH_SPRITES + 1);
+}
+
+static void DrawCommand(int i, unsigned int* lastTexture, int* drawCalls)
+{
+	const SpriteCommand* command = &commands[i];
+	if (*drawCalls == 0 || command->texture.id != *lastTexture)
+	{
+		*lastTexture = command->texture.id;
+		(*drawCalls)++;
+	}
+	if (command->layout)
+	{
+		DrawTextLayout(command->layout, (Vector2){ command->dest.x, command->dest.y }, command->tint, CommandDepth(i));
+		return;
+	}
+	DrawSpriteQuad(command->texture, command->source, command->dest, command->tint, CommandDepth(i));
+}
+
+void EndSpriteBatch(void)
+{
+	qsort(commands, commandCount, sizeof(SpriteCommand), CompareSprites);
+
+	// Sorted by texture within a layer, so opacity is looked up once per run
+	int opaqueCount = 0;
+	TextureOpacity opacity = { false, NULL };
+	for (int i = 0; i < commandCount; i++)
+	{
+		SpriteCommand* command = &commands[i];
+		if (i == 0 || command->texture.id != commands[i - 1].texture.id) opacity = GetTextureOpacity(command->texture);
+		command->opaque = IsCommandOpaque(command, opacity);
+		opaqueCount += command->opaque;
+	}
+
+	int drawCalls = 0;
+	unsigned int lastTexture = 0;
+	bool overdraw = drawView != DRAW_VIEW_NORMAL;
+	rlDrawRenderBatchActive(); // What the scenes drew directly lands underneath
+	if (overdraw) BeginBlendMode(BLEND_ADDITIVE);
+	rlEnableDepthTest();
+	if (opaqueCount > 0)
+	{
+		if (!overdraw) rlDisableColorBlend();
+		for (int i = commandCount - 1; i >= 0; i--)
+		{
+			if (commands[i].opaque) DrawCommand(i, &lastTexture, &drawCalls);
+		}
+		rlDrawRenderBatchActive();
+		rlEnableColorBlend();
+	}
+	rlDisableDepthMask();
+	for (int i = 0; i < commandCount; i++)
+	{
+		if (!commands[i].opaque) DrawCommand(i, &lastTexture, &drawCalls);
+	}
+	rlDrawRenderBatchActive();
+	rlEnableDepthMask();
+	rlDisableDepthTest();
+	if (overdraw) EndBlendMode();
+
+	lastStats.sprites = commandCount;
+	lastStats.opaqueSprites = opaqueCount;
+	lastStats.drawCalls = drawCalls;
+	commandCount = 0;
+}
+
+void ClearFrame(Color color)
+{
+	bool covered = false;
+	for (int i = 0; i < commandCount && !covered && drawView == DRAW_VIEW_NORMAL; i++)
+	{
+		const SpriteCommand* command = &commands[i];
+		covered = command->dest.x <= 0 && command->dest.y <= 0 &&
+			command->dest.x + command->dest.width >= GetScreenWidth() &&
+			command->dest.y + command->dest.height >= GetScreenHeight() && IsCommandOpaque(command, GetTextureOpacity(command->texture));
+	}
+	if (!covered)
+	{
+		ClearBackground(drawView == DRAW_VIEW_NORMAL ? color : BLACK);
+		return;
+	}
+
+	// The opaque pass still needs a cleared depth buffer
+	rlColorMask(false, false, false, false);
+	rlClearScreenBuffers();
+	rlColorMask(true, true, true, true);
+}
+
+// Same vertices as DrawTexturePro() for an unrotated quad, flips included, but with z given
+void DrawSpriteQuad(Texture2D texture, Rectangle source, Rectangle dest, Color tint, float depth)
+{
+	if (texture.id == 0) return;
+
+	bool flipX = source.width < 0;
+	if (flipX) source.width = -source.width;
+	if (source.height < 0) source.y -= source.height;
+	float left = source.x / texture.width;
+	float right = (source.x + source.width) / texture.width;
+	float top = source.y / texture.height;
+	float bottom = (source.y + source.height) / texture.height;
+	if (flipX)
+	{
+		float swap = left;
+		left = right;
+		right = swap;
+	}
+
+	if (drawView != DRAW_VIEW_NORMAL)
+	{
+		texture.id = rlGetTextureIdDefault();
+		tint = OVERDRAW_TINT;
+	}
+	rlSetTexture(texture.id);
+	rlBegin(RL_QUADS);
+	rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+	rlNormal3f(0.0f, 0.0f, 1.0f);
+	rlTexCoord2f(left, top);
+	rlVertex3f(dest.x, dest.y, depth);
+	rlTexCoord2f(left, bottom);
+	rlVertex3f(dest.x, dest.y + dest.height, depth);
+	rlTexCoord2f(right, bottom);
+	rlVertex3f(dest.x + dest.width, dest.y + dest.height, depth);
+	rlTexCoord2f(right, top);
+	rlVertex3f(dest.x + dest.width, dest.y, depth);
+	rlEnd();
+	rlSetTexture(0);
+}
+
+SpriteBatchStats GetSpriteBatchStats(void)
+{
+	return lastStats;
+}
+
+void SetDrawView(DrawView view)
+{
+	drawView = view;
+}
+
+DrawView GetDrawView(void)
+{
+	return drawView;
+}
+
+const char* GetDrawViewName(DrawView view)
+{
+	switch (view)
+	{
+	case DRAW_VIEW_OVERDRAW: return "overdraw";
+	case DRAW_VIEW_OVERDRAW_BLENDED: return "overdraw, no opaque pass";
+	default: return "normal";
+	}
+}
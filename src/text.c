@@ -0,0 +1,212 @@
+#include "text.h"
+#include "sprite_batch.h"
+#include "asset_cache.h"
+#include "arena.h"
+#include "logger.h"
+#include <string.h>
+
+typedef struct {
+	bool used;
+	unsigned int hash;
+	unsigned int textureId;
+	float size;
+	float spacing;
+	unsigned int frame; // Frame arena reset count when last handed out
+	unsigned long long lastUse;
+	char text[TEXT_LAYOUT_MAX_BYTES + 1];
+	GlyphQuad quads[TEXT_LAYOUT_MAX_BYTES]; // A glyph takes at least one byte
+	TextLayout layout;
+} LayoutSlot;
+
+static LayoutSlot slots[TEXT_LAYOUT_SETS * TEXT_LAYOUT_WAYS];
+static unsigned long long useCounter = 0;
+static TextCacheStats stats = { 0 };
+
+#if !defined(CELISE_HEADLESS)
+// The usual fwidth() smoothstep over the distance stored in the atlas alpha
+static const char* sdfFragmentShader =
+	"#version 330\n"
+	"in vec2 fragTexCoord;\n"
+	"in vec4 fragColor;\n"
+	"uniform sampler2D texture0;\n"
+	"out vec4 finalColor;\n"
+	"void main()\n"
+	"{\n"
+	"    float distance = texture(texture0, fragTexCoord).a - 0.5;\n"
+	"    float width = length(vec2(dFdx(distance), dFdy(distance)));\n"
+	"    finalColor = vec4(fragColor.rgb, fragColor.a * smoothstep(-width, width, distance));\n"
+	"}\n";
+#endif
+static Shader sdfShader = { 0 };
+
+TextFont AcquireTextFont(const char* path, int size, bool sdf)
+{
+	return (TextFont){ AcquireFontEx(path, size, sdf), sdf };
+}
+
+void ReleaseTextFont(TextFont font)
+{
+	// The texture id may be reused once the cache frees the font, so its layouts go now
+	for (int i = 0; i < TEXT_LAYOUT_SETS * TEXT_LAYOUT_WAYS; i++)
+	{
+		if (slots[i].used && slots[i].textureId == font.font.texture.id) slots[i].used = false;
+	}
+	ReleaseFont(font.font);
+}
+
+// ------ Layout ------
+
+static unsigned int HashLayout(unsigned int textureId, float size, float spacing, const char* text)
+{
+	unsigned int hash = 2166136261u;
+	unsigned int words[3] = { textureId, 0, 0 };
+	memcpy(&words[1], &size, sizeof(float));
+	memcpy(&words[2], &spacing, sizeof(float));
+	for (int i = 0; i < 3; i++)
+	{
+		hash ^= words[i];
+		hash *= 16777619u;
+	}
+	for (const unsigned char* c = (const unsigned char*)text; *c; c++)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// Same placement as DrawTextEx, written out once instead of every frame
+static void BuildLayout(const TextFont* font, const char* text, float size, float spacing, GlyphQuad* quads, int maxQuads, TextLayout* layout)
+{
+	*layout = (TextLayout){ font->font.texture, font->sdf, { 0, size }, 0, quads };
+	if (!font->font.glyphs || font->font.glyphCount == 0 || font->font.baseSize == 0) return;
+
+	float scale = size / (float)font->font.baseSize;
+	float padding = (float)font->font.glyphPadding;
+	float x = 0.0f;
+	float y = 0.0f;
+	for (int i = 0; text[i] != '\0';)
+	{
+		int bytes = 0;
+		int codepoint = GetCodepointNext(&text[i], &bytes);
+		i += bytes;
+		if (codepoint == '\n')
+		{
+			if (x - spacing > layout->size.x) layout->size.x = x - spacing;
+			x = 0.0f;
+			y += size + TEXT_LINE_SPACING;
+			layout->size.y = y + size;
+			continue;
+		}
+
+		int index = GetGlyphIndex(font->font, codepoint);
+		const GlyphInfo* glyph = &font->font.glyphs[index];
+		Rectangle rec = font->font.recs[index];
+		if (codepoint != ' ' && codepoint != '\t' && layout->quadCount < maxQuads)
+		{
+			quads[layout->quadCount++] = (GlyphQuad){
+				{ rec.x - padding, rec.y - padding, rec.width + 2 * padding, rec.height + 2 * padding },
+				{ x + (glyph->offsetX - padding) * scale, y + (glyph->offsetY - padding) * scale,
+					(rec.width + 2 * padding) * scale, (rec.height + 2 * padding) * scale }
+			};
+		}
+		x += (glyph->advanceX != 0 ? (float)glyph->advanceX : rec.width) * scale + spacing;
+	}
+	if (x - spacing > layout->size.x) layout->size.x = x - spacing;
+}
+
+static const TextLayout* LayoutUncached(const TextFont* font, const char* text, float size, float spacing)
+{
+	stats.uncached++;
+	int maxQuads = (int)strlen(text);
+	Arena* frame = GetFrameArena();
+	TextLayout* layout = (TextLayout*)ArenaAlloc(frame, sizeof(TextLayout));
+	GlyphQuad* quads = (GlyphQuad*)ArenaAlloc(frame, sizeof(GlyphQuad) * (maxQuads > 0 ? maxQuads : 1));
+	if (!layout || !quads) return NULL;
+	BuildLayout(font, text, size, spacing, quads, maxQuads, layout);
+	return layout;
+}
+
+const TextLayout* LayoutText(const TextFont* font, const char* text, float size, float spacing)
+{
+	if (!text) return NULL; // Formatting into a full frame arena yields NULL
+	if (strlen(text) > TEXT_LAYOUT_MAX_BYTES) return LayoutUncached(font, text, size, spacing);
+
+	unsigned int frame = GetFrameArena() ? GetFrameArena()->resets : 0;
+	unsigned int textureId = font->font.texture.id;
+	unsigned int hash = HashLayout(textureId, size, spacing, text);
+	LayoutSlot* set = &slots[(hash & (TEXT_LAYOUT_SETS - 1)) * TEXT_LAYOUT_WAYS];
+
+	LayoutSlot* victim = NULL;
+	for (int w = 0; w < TEXT_LAYOUT_WAYS; w++)
+	{
+		LayoutSlot* slot = &set[w];
+		if (slot->used && slot->hash == hash && slot->textureId == textureId && slot->size == size &&
+			slot->spacing == spacing && strcmp(slot->text, text) == 0)
+		{
+			slot->frame = frame;
+			slot->lastUse = ++useCounter;
+			stats.hits++;
+			return &slot->layout;
+		}
+		if (slot->used && slot->frame == frame) continue; // May already be queued for drawing
+		if (!victim || !slot->used || (victim->used && slot->lastUse < victim->lastUse)) victim = slot;
+	}
+	if (!victim) return LayoutUncached(font, text, size, spacing);
+
+	if (victim->used) stats.evictions++;
+	stats.misses++;
+	victim->used = true;
+	victim->hash = hash;
+	victim->textureId = textureId;
+	victim->size = size;
+	victim->spacing = spacing;
+	victim->frame = frame;
+	victim->lastUse = ++useCounter;
+	strcpy(victim->text, text);
+	BuildLayout(font, victim->text, size, spacing, victim->quads, TEXT_LAYOUT_MAX_BYTES, &victim->layout);
+	return &victim->layout;
+}
+
+// ------ Drawing ------
+
+void DrawTextLayout(const TextLayout* layout, Vector2 position, Color tint, float depth)
+{
+#if !defined(CELISE_HEADLESS)
+	if (layout->sdf)
+	{
+		if (sdfShader.id == 0) sdfShader = LoadShaderFromMemory(NULL, sdfFragmentShader);
+		BeginShaderMode(sdfShader);
+	}
+#endif
+	for (int i = 0; i < layout->quadCount; i++)
+	{
+		const GlyphQuad* quad = &layout->quads[i];
+		Rectangle dest = { position.x + quad->dest.x, position.y + quad->dest.y, quad->dest.width, quad->dest.height };
+		DrawSpriteQuad(layout->texture, quad->source, dest, tint, depth);
+	}
+#if !defined(CELISE_HEADLESS)
+	if (layout->sdf) EndShaderMode();
+#endif
+}
+
+void InvalidateTextLayouts(void)
+{
+	for (int i = 0; i < TEXT_LAYOUT_SETS * TEXT_LAYOUT_WAYS; i++) slots[i].used = false;
+}
+
+void ShutdownText(void)
+{
+	DebugLog(LOG_INFO, "Text layout cache: %lld hits, %lld misses, %lld evictions, %lld uncached",
+		stats.hits, stats.misses, stats.evictions, stats.uncached);
+#if !defined(CELISE_HEADLESS)
+	if (sdfShader.id != 0) UnloadShader(sdfShader);
+#endif
+	sdfShader = (Shader){ 0 };
+	memset(slots, 0, sizeof(slots));
+}
+
+TextCacheStats GetTextCacheStats(void)
+{
+	return stats;
+}
@@ -0,0 +1,356 @@
+#include "tilemap.h"
+#include "asset_cache.h"
+#include "sprite_batch.h"
+#include "game_alloc.h"
+#include "logger.h"
+#include "rlgl.h"
+#include <string.h>
+#include <math.h>
+
+Tilemap* CreateTilemap(const AtlasDesc* tiles)
+{
+	Tilemap* map = (Tilemap*)GameAlloc(sizeof(Tilemap));
+	if (!map)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate memory for Tilemap <%s>", tiles->name);
+		return NULL;
+	}
+	memset(map, 0, sizeof(Tilemap));
+
+	map->atlas = AcquireAtlas(tiles);
+	map->tileTypeCount = tiles->count < MAX_TILE_TYPES ? tiles->count : MAX_TILE_TYPES;
+	for (int i = 0; i < map->tileTypeCount; i++)
+	{
+		map->tileSources[i + 1] = GetAtlasRegion(map->atlas, tiles->paths[i]);
+		map->tileOpaque[i + 1] = IsAtlasRegionOpaque(map->atlas, tiles->paths[i]);
+	}
+	return map;
+}
+
+static void FreeChunkMesh(TileChunk* chunk)
+{
+	if (chunk->uploaded)
+	{
+		UnloadMesh(chunk->mesh); // Frees the CPU arrays too
+	}
+	else
+	{
+		MemFree(chunk->mesh.vertices);
+		MemFree(chunk->mesh.texcoords);
+		MemFree(chunk->mesh.indices);
+	}
+	memset(&chunk->mesh, 0, sizeof(Mesh));
+	chunk->uploaded = false;
+}
+
+void FreeTilemap(Tilemap* map)
+{
+	if (!map) return;
+	for (int l = 0; l < map->layerCount; l++)
+	{
+		TileLayer* layer = &map->layers[l];
+		for (int c = 0; c < layer->chunksX * layer->chunksY; c++)
+		{
+			FreeChunkMesh(&layer->chunks[c]);
+		}
+		GameFree(layer->chunks);
+		GameFree(layer->tiles);
+	}
+	if (map->materialLoaded)
+	{
+		MemFree(map->material.maps); // UnloadMaterial() would also unload the atlas texture, which the cache owns
+	}
+	ReleaseAtlas(map->atlas);
+	GameFree(map);
+}
+
+TileLayer* AddTileLayer(Tilemap* map, Vector2 origin, float tileWidth, float tileHeight, int width, int height)
+{
+	if (map->layerCount == MAX_TILEMAP_LAYERS)
+	{
+		DebugLog(LOG_ERROR, "Tilemap already has %d layers", MAX_TILEMAP_LAYERS);
+		return NULL;
+	}
+	if (tileWidth <= 0 || tileHeight <= 0 || width <= 0 || height <= 0)
+	{
+		DebugLog(LOG_WARNING, "Skipping empty tile layer (%dx%d tiles of %.0fx%.0f)", width, height, tileWidth, tileHeight);
+		return NULL;
+	}
+
+	TileLayer* layer = &map->layers[map->layerCount];
+	layer->origin = origin;
+	layer->tileWidth = tileWidth;
+	layer->tileHeight = tileHeight;
+	layer->width = width;
+	layer->height = height;
+	layer->chunksX = (width + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	layer->chunksY = (height + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	layer->tiles = (TileIndex*)GameAlloc((size_t)width * height * sizeof(TileIndex));
+	layer->chunks = (TileChunk*)GameAlloc((size_t)layer->chunksX * layer->chunksY * sizeof(TileChunk));
+	if (!layer->tiles || !layer->chunks)
+	{
+		DebugLog(LOG_ERROR, "Failed to allocate a %dx%d tile layer", width, height);
+		GameFree(layer->tiles);
+		GameFree(layer->chunks);
+		memset(layer, 0, sizeof(TileLayer));
+		return NULL;
+	}
+	memset(layer->tiles, 0, (size_t)width * height * sizeof(TileIndex));
+	memset(layer->chunks, 0, (size_t)layer->chunksX * layer->chunksY * sizeof(TileChunk));
+
+	for (int cy = 0; cy < layer->chunksY; cy++)
+	{
+		for (int cx = 0; cx < layer->chunksX; cx++)
+		{
+			TileChunk* chunk = &layer->chunks[cy * layer->chunksX + cx];
+			int tilesX = (width - cx * TILE_CHUNK_SIZE) < TILE_CHUNK_SIZE ? width - cx * TILE_CHUNK_SIZE : TILE_CHUNK_SIZE;
+			int tilesY = (height - cy * TILE_CHUNK_SIZE) < TILE_CHUNK_SIZE ? height - cy * TILE_CHUNK_SIZE : TILE_CHUNK_SIZE;
+			chunk->bounds = (Rectangle){
+				origin.x + cx * TILE_CHUNK_SIZE * tileWidth,
+				origin.y + cy * TILE_CHUNK_SIZE * tileHeight,
+				tilesX * tileWidth,
+				tilesY * tileHeight
+			};
+		}
+	}
+
+	map->layerCount++;
+	return layer;
+}
+
+void SetTile(TileLayer* layer, int x, int y, TileIndex tile)
+{
+	if (x < 0 || y < 0 || x >= layer->width || y >= layer->height) return;
+	TileIndex* cell = &layer->tiles[y * layer->width + x];
+	if (*cell == tile) return;
+	*cell = tile;
+	TileChunk* chunk = &layer->chunks[(y / TILE_CHUNK_SIZE) * layer->chunksX + x / TILE_CHUNK_SIZE];
+	if (!chunk->dirty) layer->dirtyChunks++;
+	chunk->dirty = true;
+}
+
+void FillTiles(TileLayer* layer, int x, int y, int width, int height, TileIndex tile)
+{
+	for (int ty = y; ty < y + height; ty++)
+	{
+		for (int tx = x; tx < x + width; tx++)
+		{
+			SetTile(layer, tx, ty, tile);
+		}
+	}
+}
+
+Rectangle GetTileLayerBounds(const TileLayer* layer)
+{
+	return (Rectangle){ layer->origin.x, layer->origin.y, layer->width * layer->tileWidth, layer->height * layer->tileHeight };
+}
+
+Rectangle GetTilemapBounds(const Tilemap* map)
+{
+	if (map->layerCount == 0) return (Rectangle){ 0 };
+
+	Rectangle bounds = GetTileLayerBounds(&map->layers[0]);
+	for (int l = 1; l < map->layerCount; l++)
+	{
+		Rectangle layer = GetTileLayerBounds(&map->layers[l]);
+		float right = fmaxf(bounds.x + bounds.width, layer.x + layer.width);
+		float bottom = fmaxf(bounds.y + bounds.height, layer.y + layer.height);
+		bounds.x = fminf(bounds.x, layer.x);
+		bounds.y = fminf(bounds.y, layer.y);
+		bounds.width = right - bounds.x;
+		bounds.height = bottom - bounds.y;
+	}
+	return bounds;
+}
+
+Vector2 GetTileSize(const Tilemap* map, TileIndex tile)
+{
+	if (tile == 0 || tile > map->tileTypeCount) return (Vector2){ 0, 0 };
+	return (Vector2){ map->tileSources[tile].width, map->tileSources[tile].height };
+}
+
+// ------ Chunk meshes ------
+
+static void BuildChunk(Tilemap* map, TileLayer* layer, int cx, int cy)
+{
+	TileChunk* chunk = &layer->chunks[cy * layer->chunksX + cx];
+	FreeChunkMesh(chunk);
+	chunk->dirty = false;
+
+	int x0 = cx * TILE_CHUNK_SIZE, y0 = cy * TILE_CHUNK_SIZE;
+	int x1 = x0 + TILE_CHUNK_SIZE < layer->width ? x0 + TILE_CHUNK_SIZE : layer->width;
+	int y1 = y0 + TILE_CHUNK_SIZE < layer->height ? y0 + TILE_CHUNK_SIZE : layer->height;
+
+	int quads = 0;
+	bool opaque = true;
+	for (int y = y0; y < y1; y++)
+	{
+		for (int x = x0; x < x1; x++)
+		{
+			TileIndex tile = layer->tiles[y * layer->width + x];
+			if (tile == 0 || tile > map->tileTypeCount) continue;
+			quads++;
+			opaque &= map->tileOpaque[tile];
+		}
+	}
+	chunk->quadCount = quads;
+	chunk->opaque = opaque;
+	if (quads == 0) return;
+
+	// Mesh arrays are owned by raylib once uploaded (UnloadMesh frees them), so they come from MemAlloc
+	Mesh* mesh = &chunk->mesh;
+	mesh->vertexCount = quads * 4;
+	mesh->triangleCount = quads * 2;
+	mesh->vertices = (float*)MemAlloc(mesh->vertexCount * 3 * sizeof(float));
+	mesh->texcoords = (float*)MemAlloc(mesh->vertexCount * 2 * sizeof(float));
+	mesh->indices = (unsigned short*)MemAlloc(mesh->triangleCount * 3 * sizeof(unsigned short));
+
+	float texWidth = (float)map->atlas->texture.width;
+	float texHeight = (float)map->atlas->texture.height;
+	int q = 0;
+	for (int y = y0; y < y1; y++)
+	{
+		for (int x = x0; x < x1; x++)
+		{
+			TileIndex tile = layer->tiles[y * layer->width + x];
+			if (tile == 0 || tile > map->tileTypeCount) continue;
+
+			Rectangle src = map->tileSources[tile];
+			float left = layer->origin.x + x * layer->tileWidth;
+			float top = layer->origin.y + y * layer->tileHeight;
+			float right = left + layer->tileWidth;
+			float bottom = top + layer->tileHeight;
+			float u0 = src.x / texWidth, v0 = src.y / texHeight;
+			float u1 = (src.x + src.width) / texWidth, v1 = (src.y + src.height) / texHeight;
+
+			// Same corner order as raylib's own quads: top-left, bottom-left, bottom-right, top-right
+			float corners[4][4] = {
+				{ left, top, u0, v0 }, { left, bottom, u0, v1 }, { right, bottom, u1, v1 }, { right, top, u1, v0 }
+			};
+			for (int v = 0; v < 4; v++)
+			{
+				int vertex = q * 4 + v;
+				mesh->vertices[vertex * 3 + 0] = corners[v][0];
+				mesh->vertices[vertex * 3 + 1] = corners[v][1];
+				mesh->vertices[vertex * 3 + 2] = 0.0f;
+				mesh->texcoords[vertex * 2 + 0] = corners[v][2];
+				mesh->texcoords[vertex * 2 + 1] = corners[v][3];
+			}
+			unsigned short base = (unsigned short)(q * 4);
+			unsigned short* index = &mesh->indices[q * 6];
+			index[0] = base; index[1] = base + 1; index[2] = base + 2;
+			index[3] = base; index[4] = base + 2; index[5] = base + 3;
+			q++;
+		}
+	}
+}
+
+void BuildTilemap(Tilemap* map)
+{
+	for (int l = 0; l < map->layerCount; l++)
+	{
+		TileLayer* layer = &map->layers[l];
+		if (layer->dirtyChunks == 0) continue;
+		for (int cy = 0; cy < layer->chunksY; cy++)
+		{
+			for (int cx = 0; cx < layer->chunksX; cx++)
+			{
+				if (layer->chunks[cy * layer->chunksX + cx].dirty) BuildChunk(map, layer, cx, cy);
+			}
+		}
+		layer->dirtyChunks = 0;
+	}
+}
+
+// Chunk range of layer overlapping view; false if none does
+static bool GetVisibleChunks(const TileLayer* layer, Rectangle view, int* cx0, int* cy0, int* cx1, int* cy1)
+{
+	if (!CheckCollisionRecs(GetTileLayerBounds(layer), view)) return false;
+
+	// Only the chunk range overlapping the view is visited, so cost does not grow with level size
+	*cx0 = (int)((view.x - layer->origin.x) / (layer->tileWidth * TILE_CHUNK_SIZE));
+	*cy0 = (int)((view.y - layer->origin.y) / (layer->tileHeight * TILE_CHUNK_SIZE));
+	*cx1 = (int)((view.x + view.width - layer->origin.x) / (layer->tileWidth * TILE_CHUNK_SIZE));
+	*cy1 = (int)((view.y + view.height - layer->origin.y) / (layer->tileHeight * TILE_CHUNK_SIZE));
+	*cx0 = *cx0 < 0 ? 0 : *cx0;
+	*cy0 = *cy0 < 0 ? 0 : *cy0;
+	*cx1 = *cx1 >= layer->chunksX ? layer->chunksX - 1 : *cx1;
+	*cy1 = *cy1 >= layer->chunksY ? layer->chunksY - 1 : *cy1;
+	return true;
+}
+
+// Layer l sits at this depth, all of them behind the sprite batch
+static float TileLayerDepth(int l)
+{
+	return -1.0f + (SPRITE_DEPTH_FAR + 1.0f) * (float)(l + 1) / (float)(MAX_TILEMAP_LAYERS + 1);
+}
+
+static void DrawChunks(Tilemap* map, int l, Rectangle view, bool opaque, TilemapDrawStats* stats)
+{
+	TileLayer* layer = &map->layers[l];
+	int cx0, cy0, cx1, cy1;
+	if (!GetVisibleChunks(layer, view, &cx0, &cy0, &cx1, &cy1)) return;
+
+	const Matrix transform = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, TileLayerDepth(l), 0, 0, 0, 1 };
+	for (int cy = cy0; cy <= cy1; cy++)
+	{
+		for (int cx = cx0; cx <= cx1; cx++)
+		{
+			TileChunk* chunk = &layer->chunks[cy * layer->chunksX + cx];
+			if (chunk->quadCount == 0 || chunk->opaque != opaque) continue;
+			if (!chunk->uploaded)
+			{
+				UploadMesh(&chunk->mesh, false);
+				chunk->uploaded = true;
+			}
+			DrawMesh(chunk->mesh, map->material, transform);
+			stats->chunksDrawn++;
+			stats->quads += chunk->quadCount;
+		}
+	}
+}
+
+TilemapDrawStats DrawTilemap(Tilemap* map, Rectangle view)
+{
+	TilemapDrawStats stats = { 0 };
+	BuildTilemap(map);
+
+	if (!map->materialLoaded)
+	{
+		map->material = LoadMaterialDefault();
+		map->materialLoaded = true;
+	}
+	DrawView drawView = GetDrawView();
+	bool overdraw = drawView != DRAW_VIEW_NORMAL;
+	MaterialMap* diffuse = &map->material.maps[MATERIAL_MAP_DIFFUSE];
+	diffuse->texture = overdraw ? (Texture2D){ rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 } : map->atlas->texture;
+	diffuse->color = overdraw ? OVERDRAW_TINT : WHITE;
+
+	for (int l = 0; l < map->layerCount; l++)
+	{
+		TileLayer* layer = &map->layers[l];
+		int cx0, cy0, cx1, cy1;
+		int visible = GetVisibleChunks(layer, view, &cx0, &cy0, &cx1, &cy1) ? (cx1 - cx0 + 1) * (cy1 - cy0 + 1) : 0;
+		stats.chunksCulled += layer->chunksX * layer->chunksY - visible;
+	}
+
+	rlDrawRenderBatchActive(); // Anything queued before the map must land underneath it
+	if (overdraw) BeginBlendMode(BLEND_ADDITIVE);
+	rlEnableDepthTest();
+	if (drawView != DRAW_VIEW_OVERDRAW_BLENDED)
+	{
+		if (!overdraw) rlDisableColorBlend();
+		for (int l = map->layerCount - 1; l >= 0; l--) DrawChunks(map, l, view, true, &stats);
+		rlEnableColorBlend();
+	}
+	rlDisableDepthMask();
+	for (int l = 0; l < map->layerCount; l++)
+	{
+		DrawChunks(map, l, view, false, &stats);
+		if (drawView == DRAW_VIEW_OVERDRAW_BLENDED) DrawChunks(map, l, view, true, &stats);
+	}
+	rlEnableDepthMask();
+	rlDisableDepthTest();
+	if (overdraw) EndBlendMode();
+	return stats;
+}
@@ -0,0 +1,73 @@
+#include "world_camera.h"
+#include "game.h"
+#include <math.h>
+
+#define CAMERA_FOLLOW_RATE 0.85f // Fraction of the distance left after one 60 Hz step
+
+static float ClampAxis(float target, float halfView, float min, float max)
+{
+	if (max - min <= halfView * 2) return (min + max) * 0.5f; // Bounds narrower than the view: centre them
+	if (target < min + halfView) return min + halfView;
+	if (target > max - halfView) return max - halfView;
+	return target;
+}
+
+static Vector2 ClampTarget(const WorldCamera* camera, Vector2 target)
+{
+	float halfWidth = camera->camera.offset.x / camera->camera.zoom;
+	float halfHeight = camera->camera.offset.y / camera->camera.zoom;
+	return (Vector2){
+		ClampAxis(target.x, halfWidth, camera->bounds.x, camera->bounds.x + camera->bounds.width),
+		ClampAxis(target.y, halfHeight, camera->bounds.y, camera->bounds.y + camera->bounds.height)
+	};
+}
+
+void InitWorldCamera(WorldCamera* camera, Rectangle bounds, Vector2 focus)
+{
+	camera->bounds = bounds;
+	camera->camera.offset = (Vector2){ GetGameWidth() / 2.0f, GetGameHeight() / 2.0f };
+	camera->camera.rotation = 0.0f;
+	camera->camera.zoom = 1.0f;
+	camera->camera.target = ClampTarget(camera, focus);
+	camera->prevTarget = camera->camera.target;
+}
+
+void UpdateWorldCamera(WorldCamera* camera, Vector2 focus, float dt)
+{
+	camera->prevTarget = camera->camera.target;
+	camera->camera.offset = (Vector2){ GetGameWidth() / 2.0f, GetGameHeight() / 2.0f }; // Follows window resizes
+
+	float t = 1.0f - powf(CAMERA_FOLLOW_RATE, dt * 60.0f);
+	Vector2 target = camera->camera.target;
+	target.x += (focus.x - target.x) * t;
+	target.y += (focus.y - target.y) * t;
+	camera->camera.target = ClampTarget(camera, target);
+}
+
+Camera2D GetRenderCamera(const WorldCamera* camera, float alpha)
+{
+	Camera2D result = camera->camera;
+	result.target.x = camera->prevTarget.x + (camera->camera.target.x - camera->prevTarget.x) * alpha;
+	result.target.y = camera->prevTarget.y + (camera->camera.target.y - camera->prevTarget.y) * alpha;
+	return result;
+}
+
+Rectangle GetCameraView(Camera2D camera)
+{
+	return (Rectangle){
+		camera.target.x - camera.offset.x / camera.zoom,
+		camera.target.y - camera.offset.y / camera.zoom,
+		camera.offset.x * 2 / camera.zoom,
+		camera.offset.y * 2 / camera.zoom
+	};
+}
+
+Rectangle WorldToScreenRect(Camera2D camera, Rectangle rect)
+{
+	return (Rectangle){
+		(rect.x - camera.target.x) * camera.zoom + camera.offset.x,
+		(rect.y - camera.target.y) * camera.zoom + camera.offset.y,
+		rect.width * camera.zoom,
+		rect.height * camera.zoom
+	};
+}
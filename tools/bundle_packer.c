@@ -0,0 +1,333 @@
+#include "raylib.h"
+#include "bundle.h"
+#include "asset_cache.h"
+#include "animation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Build-time packer for the asset bundle (see bundle.h). Walks a resource directory,
+// decodes every PNG to RGBA8 and bakes every TTF/OTF the same way the asset cache does at
+// run time (the default size, each of FONT_BAKED_SIZES and a distance field), bakes every
+// .anim spec with its frames trimmed to their opaque pixels, then writes one file the
+// game can map and read in place.
+//
+// Usage: CeliseBundle [resource dir] [output]    defaults: resources celise.bundle
+
+typedef struct {
+	BundleEntry entry;
+	void* payload; // Written at entry.offset
+} PackedAsset;
+
+static void NormalizePath(char* path)
+{
+	for (char* c = path; *c; c++)
+	{
+		if (*c == '\\') *c = '/';
+	}
+}
+
+static bool PackImage(const char* file, PackedAsset* asset)
+{
+	Image image = LoadImage(file);
+	if (!image.data) return false;
+	ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	asset->entry.format = BUNDLE_IMAGE;
+	asset->entry.width = image.width;
+	asset->entry.height = image.height;
+	asset->entry.pixelFormat = image.format;
+	asset->entry.size = (uint64_t)GetPixelDataSize(image.width, image.height, image.format);
+	asset->payload = image.data; // Freed with MemFree after writing
+	return true;
+}
+
+static bool PackFont(const char* file, int size, bool sdf, PackedAsset* asset)
+{
+	int dataSize = 0;
+	unsigned char* data = LoadFileData(file, &dataSize);
+	if (!data) return false;
+
+	int codepoints[FONT_GLYPH_COUNT];
+	GetFontCodepoints(codepoints);
+	GlyphInfo* glyphs = LoadFontData(data, dataSize, size, codepoints, FONT_GLYPH_COUNT, sdf ? FONT_SDF : FONT_DEFAULT);
+	UnloadFileData(data);
+	if (!glyphs) return false;
+
+	Rectangle* recs = NULL;
+	Image atlas = GenImageFontAtlas(glyphs, &recs, FONT_GLYPH_COUNT, size, FONT_GLYPH_PADDING, 0);
+	if (!atlas.data)
+	{
+		UnloadFontData(glyphs, FONT_GLYPH_COUNT);
+		MemFree(recs);
+		return false;
+	}
+
+	size_t glyphBytes = sizeof(BundleGlyph) * FONT_GLYPH_COUNT;
+	size_t pixelBytes = (size_t)GetPixelDataSize(atlas.width, atlas.height, atlas.format);
+	unsigned char* payload = (unsigned char*)MemAlloc((unsigned int)(glyphBytes + pixelBytes));
+	BundleGlyph* records = (BundleGlyph*)payload;
+	for (int i = 0; i < FONT_GLYPH_COUNT; i++)
+	{
+		records[i] = (BundleGlyph){ glyphs[i].value, glyphs[i].offsetX, glyphs[i].offsetY, glyphs[i].advanceX,
+			recs[i].x, recs[i].y, recs[i].width, recs[i].height };
+	}
+	memcpy(payload + glyphBytes, atlas.data, pixelBytes);
+
+	asset->entry.format = BUNDLE_FONT;
+	asset->entry.width = atlas.width;
+	asset->entry.height = atlas.height;
+	asset->entry.pixelFormat = atlas.format;
+	asset->entry.glyphCount = FONT_GLYPH_COUNT;
+	asset->entry.baseSize = size;
+	asset->entry.glyphPadding = FONT_GLYPH_PADDING;
+	asset->entry.size = glyphBytes + pixelBytes;
+	asset->payload = payload;
+
+	UnloadImage(atlas);
+	UnloadFontData(glyphs, FONT_GLYPH_COUNT);
+	MemFree(recs);
+	return true;
+}
+
+// Smallest rectangle of cell holding a pixel that is not fully transparent; empty cells
+// come out 0 x 0
+static Rectangle TrimCell(const Image* sheet, Rectangle cell)
+{
+	const unsigned char* pixels = (const unsigned char*)sheet->data;
+	int left = (int)cell.x, top = (int)cell.y;
+	int right = (int)(cell.x + cell.width), bottom = (int)(cell.y + cell.height);
+	if (right > sheet->width) right = sheet->width;
+	if (bottom > sheet->height) bottom = sheet->height;
+
+	int minX = right, minY = bottom, maxX = left - 1, maxY = top - 1;
+	for (int y = top; y < bottom; y++)
+	{
+		for (int x = left; x < right; x++)
+		{
+			if (pixels[((size_t)y * sheet->width + x) * 4 + 3] == 0) continue;
+			if (x < minX) minX = x;
+			if (x > maxX) maxX = x;
+			if (y < minY) minY = y;
+			if (y > maxY) maxY = y;
+		}
+	}
+	if (maxX < minX) return (Rectangle){ cell.x, cell.y, 0, 0 };
+	return (Rectangle){ (float)minX, (float)minY, (float)(maxX - minX + 1), (float)(maxY - minY + 1) };
+}
+
+static bool PackClips(const char* file, const char* resourceDir, PackedAsset* asset)
+{
+	char* text = LoadFileText(file);
+	if (!text) return false;
+	AnimationSpec spec;
+	char error[128] = { 0 };
+	bool parsed = ParseAnimationSpec(text, &spec, error, sizeof(error));
+	UnloadFileText(text);
+	if (!parsed)
+	{
+		printf("  %s: %s\n", file, error);
+		return false;
+	}
+
+	const char* sheetPaths[ANIMATION_MAX_SHEETS];
+	Image sheets[ANIMATION_MAX_SHEETS] = { 0 };
+	int sheetCount = 0;
+	int frameCount = 0;
+	ClipRecord clips[ENTITY_STATE_COUNT];
+	ClipFrameRecord frames[ANIMATION_MAX_FRAMES];
+	long long cellPixels = 0, trimmedPixels = 0;
+	bool ok = true;
+	for (int c = 0; c < spec.clipCount && ok; c++)
+	{
+		const AnimationSpecClip* clip = &spec.clips[c];
+		int sheet = 0;
+		while (sheet < sheetCount && strcmp(sheetPaths[sheet], clip->sheet) != 0) sheet++;
+		if (sheet == sheetCount)
+		{
+			if (sheetCount == ANIMATION_MAX_SHEETS)
+			{
+				printf("  %s: more than %d sheets\n", file, ANIMATION_MAX_SHEETS);
+				ok = false;
+				break;
+			}
+			sheets[sheet] = LoadImage(TextFormat("%s/%s", resourceDir, clip->sheet));
+			if (!sheets[sheet].data)
+			{
+				printf("  %s: cannot load sheet <%s>\n", file, clip->sheet);
+				ok = false;
+				break;
+			}
+			ImageFormat(&sheets[sheet], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+			sheetPaths[sheetCount++] = clip->sheet;
+		}
+
+		clips[c] = (ClipRecord){ (uint8_t)clip->state, (uint8_t)sheet, clip->loop, 0, (uint16_t)frameCount, (uint16_t)clip->cellCount };
+		for (int f = 0; f < clip->cellCount; f++)
+		{
+			Rectangle cell = { (float)((clip->firstCell + f) * spec.cellWidth), 0, (float)spec.cellWidth, (float)spec.cellHeight };
+			Rectangle trimmed = TrimCell(&sheets[sheet], cell);
+			frames[frameCount++] = (ClipFrameRecord){
+				(uint16_t)trimmed.x, (uint16_t)trimmed.y, (uint16_t)trimmed.width, (uint16_t)trimmed.height,
+				(int16_t)(trimmed.x - cell.x), (int16_t)(trimmed.y - cell.y), (uint16_t)clip->durationMs, 0
+			};
+			cellPixels += (long long)spec.cellWidth * spec.cellHeight;
+			trimmedPixels += (long long)trimmed.width * trimmed.height;
+		}
+	}
+	for (int s = 0; s < sheetCount; s++) UnloadImage(sheets[s]);
+	if (!ok) return false;
+
+	size_t pathBytes = (size_t)sheetCount * ANIMATION_MAX_PATH;
+	size_t size = sizeof(ClipSetHeader) + pathBytes + sizeof(ClipRecord) * spec.clipCount + sizeof(ClipFrameRecord) * frameCount;
+	unsigned char* payload = (unsigned char*)MemAlloc((unsigned int)size);
+	ClipSetHeader header = { (uint16_t)spec.cellWidth, (uint16_t)spec.cellHeight, (uint16_t)sheetCount,
+		(uint16_t)spec.clipCount, (uint16_t)frameCount, { 0 } };
+	unsigned char* at = payload;
+	memcpy(at, &header, sizeof(header));
+	at += sizeof(header);
+	for (int s = 0; s < sheetCount; s++) snprintf((char*)at + s * ANIMATION_MAX_PATH, ANIMATION_MAX_PATH, "%s", sheetPaths[s]);
+	at += pathBytes;
+	memcpy(at, clips, sizeof(ClipRecord) * spec.clipCount);
+	at += sizeof(ClipRecord) * spec.clipCount;
+	memcpy(at, frames, sizeof(ClipFrameRecord) * frameCount);
+
+	asset->entry.format = BUNDLE_CLIPS;
+	asset->entry.width = spec.cellWidth;
+	asset->entry.height = spec.cellHeight;
+	asset->entry.size = size;
+	asset->payload = payload;
+	printf("  %s: %d frames, trimmed to %lld%% of their cells\n", file, frameCount, cellPixels > 0 ? trimmedPixels * 100 / cellPixels : 0);
+	return true;
+}
+
+static int CompareAssets(const void* a, const void* b)
+{
+	const BundleEntry* x = &((const PackedAsset*)a)->entry;
+	const BundleEntry* y = &((const PackedAsset*)b)->entry;
+	if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+	return strcmp(x->path, y->path);
+}
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+	return (offset + BUNDLE_ALIGNMENT - 1) & ~(uint64_t)(BUNDLE_ALIGNMENT - 1);
+}
+
+static bool WriteBundle(const char* outPath, PackedAsset* assets, int count)
+{
+	FILE* file = fopen(outPath, "wb");
+	if (!file)
+	{
+		printf("Cannot write <%s>\n", outPath);
+		return false;
+	}
+
+	// Sorted by hash so the game can binary search the index in place
+	qsort(assets, count, sizeof(PackedAsset), CompareAssets);
+	uint64_t offset = AlignOffset(sizeof(BundleHeader) + sizeof(BundleEntry) * (uint64_t)count);
+	for (int i = 0; i < count; i++)
+	{
+		assets[i].entry.offset = offset;
+		offset = AlignOffset(offset + assets[i].entry.size);
+	}
+
+	BundleHeader header = { BUNDLE_MAGIC, BUNDLE_VERSION, (uint32_t)count, 0 };
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (int i = 0; i < count && ok; i++)
+	{
+		ok = fwrite(&assets[i].entry, sizeof(BundleEntry), 1, file) == 1;
+	}
+
+	static const unsigned char zeros[BUNDLE_ALIGNMENT] = { 0 };
+	for (int i = 0; i < count && ok; i++)
+	{
+		long padding = (long)assets[i].entry.offset - ftell(file);
+		ok = fwrite(zeros, 1, (size_t)padding, file) == (size_t)padding &&
+			fwrite(assets[i].payload, 1, (size_t)assets[i].entry.size, file) == assets[i].entry.size;
+	}
+
+	ok = fclose(file) == 0 && ok;
+	if (!ok) printf("Failed writing <%s>\n", outPath);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	const char* resourceDir = argc > 1 ? argv[1] : "resources";
+	const char* outPath = argc > 2 ? argv[2] : ASSET_BUNDLE_FILE;
+	SetTraceLogLevel(LOG_WARNING);
+
+	if (!DirectoryExists(resourceDir))
+	{
+		printf("Resource directory <%s> not found\n", resourceDir);
+		return 1;
+	}
+
+	FilePathList files = LoadDirectoryFilesEx(resourceDir, ".png;.ttf;.otf;.anim", true);
+	static const int bakedSizes[] = FONT_BAKED_SIZES;
+	int bakedSizeCount = (int)(sizeof(bakedSizes) / sizeof(bakedSizes[0]));
+	int maxAssets = (int)files.count * (bakedSizeCount + 2); // Fonts: default, each baked size, SDF
+	PackedAsset* assets = (PackedAsset*)calloc(maxAssets > 0 ? maxAssets : 1, sizeof(PackedAsset));
+	int count = 0;
+	size_t prefix = strlen(resourceDir) + 1;
+
+	for (unsigned int i = 0; i < files.count; i++)
+	{
+		const char* file = files.paths[i];
+		char path[BUNDLE_MAX_PATH];
+		if (strlen(file + prefix) + 8 >= BUNDLE_MAX_PATH) // Room for a "@<size>" suffix
+		{
+			printf("  skipped %s (path too long)\n", file);
+			continue;
+		}
+		snprintf(path, sizeof(path), "%s", file + prefix);
+		NormalizePath(path);
+
+		bool isImage = IsFileExtension(file, ".png");
+		bool isClips = IsFileExtension(file, ".anim");
+		int variants = isImage || isClips ? 1 : bakedSizeCount + 2;
+		for (int v = 0; v < variants; v++)
+		{
+			PackedAsset* asset = &assets[count];
+			bool packed;
+			if (isImage)
+			{
+				snprintf(asset->entry.path, BUNDLE_MAX_PATH, "%s", path);
+				packed = PackImage(file, asset);
+			}
+			else if (isClips)
+			{
+				snprintf(asset->entry.path, BUNDLE_MAX_PATH, "%s", path);
+				packed = PackClips(file, resourceDir, asset);
+			}
+			else
+			{
+				int size = v == 0 ? FONT_BASE_SIZE : v <= bakedSizeCount ? bakedSizes[v - 1] : FONT_SDF_SIZE;
+				bool sdf = v == bakedSizeCount + 1;
+				if (!sdf && v > 0 && size == FONT_BASE_SIZE) continue; // Same as the default bake
+				FormatFontKey(asset->entry.path, BUNDLE_MAX_PATH, path, size, sdf);
+				packed = PackFont(file, size, sdf, asset);
+			}
+			if (!packed)
+			{
+				printf("  skipped %s (could not decode)\n", asset->entry.path);
+				memset(asset, 0, sizeof(*asset));
+				continue;
+			}
+
+			asset->entry.hash = HashBundlePath(asset->entry.path);
+			printf("  %-48s %5d x %-5d %8llu KB\n", asset->entry.path, asset->entry.width, asset->entry.height,
+				(unsigned long long)(asset->entry.size / 1024));
+			count++;
+		}
+	}
+	UnloadDirectoryFiles(files);
+
+	bool ok = WriteBundle(outPath, assets, count);
+	if (ok) printf("Packed %d assets into <%s>\n", count, outPath);
+
+	for (int i = 0; i < count; i++) MemFree(assets[i].payload);
+	free(assets);
+	return ok ? 0 : 1;
+}